@@ -1,24 +1,24 @@
-#include "FramelessHelper.hpp"
+#include "framelesshelper.hpp"
 #include "FramelessDialog.h"
 #include <QDialogButtonBox>
 #include <QVBoxLayout>
+#include <memory>
 
-FramelessDialog::FramelessDialog(QWidget *parent, Theme theme)
-    : FramelessDialog(QDialogButtonBox::Ok | QDialogButtonBox::Cancel, parent, theme)
+FramelessDialog::FramelessDialog(QWidget *parent, Theme theme, ThemeMode mode)
+    : FramelessDialog(QDialogButtonBox::Ok | QDialogButtonBox::Cancel, parent, theme, mode)
 {
 }
 
-FramelessDialog::FramelessDialog(QDialogButtonBox::StandardButtons buttons, QWidget *parent, Theme theme)
+FramelessDialog::FramelessDialog(QDialogButtonBox::StandardButtons buttons, QWidget *parent, Theme theme,
+                                 ThemeMode mode)
     : QDialog(parent, Qt::Dialog)
-    , helper_(new FramelessHelper(this, theme))
+    , helper_(new FramelessHelper(this, theme, mode))
     , content_(new QVBoxLayout)
-    , central_(new QWidget(this))
 {
     setWindowFlag(Qt::WindowContextHelpButtonHint, false);
 
     auto box = new QDialogButtonBox(buttons, this);
     content_->setContentsMargins(9, 9, 9, 9);
-    content_->addWidget(central_, 1);
     content_->addWidget(box);
 
     auto layout = new QVBoxLayout(this);
@@ -37,8 +37,12 @@ FramelessDialog::~FramelessDialog()
 
 void FramelessDialog::setCentralWidget(QWidget *widget)
 {
-    content_->replaceWidget(central_, widget);
-    central_->deleteLater();
+    if (central_) {
+        content_->replaceWidget(central_, widget);
+        central_->deleteLater();
+    } else {
+        content_->insertWidget(0, widget, 1);
+    }
     central_ = widget;
     central_->setSizePolicy(QSizePolicy::Expanding, QSizePolicy::Expanding);
 }
@@ -48,6 +52,50 @@ QWidget *FramelessDialog::centralWidget() const
     return central_;
 }
 
+QWidget *FramelessDialog::takeCentralWidget()
+{
+    auto widget = central_;
+    if (widget) {
+        content_->removeWidget(widget);
+        widget->setParent(nullptr);
+        central_ = nullptr;
+    }
+    return widget;
+}
+
+void FramelessDialog::setThemeMode(ThemeMode mode)
+{
+    helper_->setThemeMode(mode);
+}
+
+void FramelessDialog::openAsync(std::function<void(int result)> onFinished)
+{
+    // Traced from open() until the dialog is finished
+    const qint64 start = Tracer::isEnabled() ? Tracer::now() : -1;
+    auto connection = std::make_shared<QMetaObject::Connection>();
+    *connection = connect(this, &QDialog::finished, this, [connection, onFinished, start](int result) {
+        QObject::disconnect(*connection);
+        if (start >= 0) {
+            Tracer::complete("dialog open", "dialog", start, Tracer::now());
+        }
+        if (onFinished) {
+            onFinished(result);
+        }
+    });
+    open();
+}
+
+int FramelessDialog::exec()
+{
+    TraceScope trace("dialog exec", "dialog");
+    return QDialog::exec();
+}
+
+FramelessMemoryReport FramelessDialog::memoryReport() const
+{
+    return helper_->memoryReport();
+}
+
 void FramelessDialog::onAccepted()
 {
     accept();
@@ -59,22 +107,15 @@ void FramelessDialog::onRejected()
 }
 
 bool FramelessDialog::event(QEvent *event) {
+    const TraceScope trace = TraceScope::forHostEvent(event);
     switch (event->type()) {
         case QEvent::WindowActivate: {
-            auto menu = helper_->titleBar();
-            if (menu) {
-                menu->setProperty("bar-active", true);
-                style()->polish(menu);
-            }
+            helper_->setBarActive(true);
             break;
         }
 
         case QEvent::WindowDeactivate: {
-            auto menu = helper_->titleBar();
-            if (menu) {
-                menu->setProperty("bar-active", false);
-                style()->polish(menu);
-            }
+            helper_->setBarActive(false);
             break;
         }
 
@@ -3,19 +3,34 @@
 #include "framelesshelper.hpp"
 #include <QDialog>
 #include <QDialogButtonBox>
+#include <functional>
 
 class FramelessDialog : public QDialog
 {
     Q_OBJECT;
 
 public:
-    explicit FramelessDialog(QWidget *parent, Theme theme = Theme::Dark);
-    explicit FramelessDialog(QDialogButtonBox::StandardButtons, QWidget *parget, Theme theme = Theme::Dark);
+    explicit FramelessDialog(QWidget *parent, Theme theme = Theme::Dark,
+                             ThemeMode mode = ThemeMode::StyleSheet);
+    explicit FramelessDialog(QDialogButtonBox::StandardButtons, QWidget *parget, Theme theme = Theme::Dark,
+                             ThemeMode mode = ThemeMode::StyleSheet);
     virtual ~FramelessDialog() override;
 
 public:
     void setCentralWidget(QWidget *widget);
     QWidget *centralWidget() const;
+    QWidget *takeCentralWidget();
+
+    void setThemeMode(ThemeMode mode);
+
+    // Shows the dialog window modal and returns right away, without the nested
+    // event loop of exec(). onFinished runs once with QDialog::Accepted or
+    // QDialog::Rejected when the dialog is closed.
+    void openAsync(std::function<void(int result)> onFinished);
+
+    int exec() override;
+
+    FramelessMemoryReport memoryReport() const;
 
 protected:
     virtual void onAccepted();
@@ -0,0 +1,20 @@
+# 各基准共用的配置
+
+QT       += core gui widgets testlib
+
+TEMPLATE = app
+
+CONFIG += c++17 console
+CONFIG -= app_bundle
+
+# 窗口与辅助类
+include($$PWD/../framelesswindow.pri)
+
+# QWK_TEST_MAIN 等共用的测试工具与进程统计
+HEADERS += \
+    $$PWD/qwkbench.h
+
+INCLUDEPATH += $$PWD $$PWD/../tests
+
+# processRssBytes()
+win32: LIBS += -lpsapi
@@ -0,0 +1,24 @@
+#-------------------------------------------------#
+# 基准：离屏平台运行，输出耗时与计数              #
+#-------------------------------------------------#
+
+TEMPLATE = subdirs
+
+SUBDIRS += \
+    clock \
+    dialog \
+    hittest \
+    iconcache \
+    menumodel \
+    preload \
+    startup \
+    themeswitch \
+    titleupdates \
+    updatechannel \
+    windows
+
+
+
+
+# preload 运行 startup 的程序
+preload.depends = startup
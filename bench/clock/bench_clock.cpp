@@ -0,0 +1,137 @@
+// Wake-ups and CPU time of 50 clocks spread over 5 windows: every clock on a
+// private 100 ms timer as ClockWidget was, and all of them on the shared
+// TickService, with the windows shown and hidden. Each row runs the event
+// loop for a few seconds; the results are scaled to one minute.
+//
+//     QT_QPA_PLATFORM=offscreen ./QWKBench_Clock
+
+#include <memory>
+#include <vector>
+
+#include <QtCore/QElapsedTimer>
+#include <QtCore/QEventLoop>
+#include <QtCore/QTime>
+#include <QtCore/QTimer>
+#include <QtWidgets/QVBoxLayout>
+
+#include "qwktest.h"
+#include "qwkbench.h"
+#include "tickservice.hpp"
+
+// The clock before the TickService: its own 100 ms timer and a setText() on
+// every timeout
+class TimerClock : public QLabel {
+public:
+    explicit TimerClock(QWidget *parent) : QLabel(parent) {
+        setAlignment(Qt::AlignCenter);
+        startTimer(100);
+    }
+
+protected:
+    void timerEvent(QTimerEvent *event) override {
+        QLabel::timerEvent(event);
+        setText(QTime::currentTime().toString(QStringLiteral("hh:mm:ss")));
+    }
+};
+
+// A clock on the TickService, the text is only set when it changed
+class TickClock : public QLabel {
+public:
+    explicit TickClock(QWidget *parent) : QLabel(parent) {
+        setAlignment(Qt::AlignCenter);
+        TickService::instance()->subscribe(this, [this](const QTime &time) {
+            const QString text = time.toString(QStringLiteral("hh:mm:ss"));
+            if (text != this->text()) {
+                setText(text);
+            }
+        });
+    }
+};
+
+// Counts the timer events of the GUI thread, one per timer wake-up
+class TimerEventCounter : public QObject {
+public:
+    TimerEventCounter() {
+        QCoreApplication::instance()->installEventFilter(this);
+    }
+
+    int events{0};
+
+protected:
+    bool eventFilter(QObject *obj, QEvent *event) override {
+        if (event->type() == QEvent::Timer) {
+            ++events;
+        }
+        return QObject::eventFilter(obj, event);
+    }
+};
+
+class bench_Clock : public QObject {
+    Q_OBJECT
+
+private Q_SLOTS:
+    void wakeups_data();
+    void wakeups();
+
+private:
+    // Runs the event loop, unlike QTest::qWait() which polls
+    static void run(int ms) {
+        QEventLoop loop;
+        QTimer::singleShot(ms, &loop, &QEventLoop::quit);
+        loop.exec();
+    }
+};
+
+void bench_Clock::wakeups_data() {
+    QTest::addColumn<bool>("shared");
+    QTest::addColumn<bool>("visible");
+
+    QTest::newRow("timer per clock") << false << true;
+    QTest::newRow("tick service") << true << true;
+    QTest::newRow("tick service, windows hidden") << true << false;
+}
+
+void bench_Clock::wakeups() {
+    QFETCH(bool, shared);
+    QFETCH(bool, visible);
+    static constexpr const int windows = 5;
+    static constexpr const int clocksPerWindow = 10;
+    static constexpr const int durationMs = 5000;
+
+    std::vector<std::unique_ptr<QWidget>> hosts;
+    for (int i = 0; i < windows; ++i) {
+        auto host = std::make_unique<QWidget>();
+        auto layout = new QVBoxLayout(host.get());
+        for (int j = 0; j < clocksPerWindow; ++j) {
+            QWidget *clock = shared ? static_cast<QWidget *>(new TickClock(host.get()))
+                                    : new TimerClock(host.get());
+            layout->addWidget(clock);
+        }
+        host->show();
+        QVERIFY(QTest::qWaitForWindowExposed(host.get()));
+        hosts.push_back(std::move(host));
+    }
+    if (!visible) {
+        for (auto &host : hosts) {
+            host->hide();
+        }
+    }
+    // The timers settle after the windows were shown or hidden
+    run(1000);
+
+    TimerEventCounter counter;
+    const qint64 cpuBefore = processCpuNs();
+    QElapsedTimer elapsed;
+    elapsed.start();
+    run(durationMs);
+    const qint64 cpuNs = processCpuNs() - cpuBefore;
+    const double minutes = elapsed.nsecsElapsed() / 60e9;
+
+    QTest::setBenchmarkResult(counter.events / minutes, QTest::Events);
+    qInfo("%.0f wake-ups and %.1f ms of CPU time per minute", counter.events / minutes,
+          cpuNs / 1e6 / minutes);
+}
+
+QWK_TEST_MAIN(bench_Clock)
+
+#include "bench_clock.moc"
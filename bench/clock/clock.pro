@@ -0,0 +1,6 @@
+TARGET = QWKBench_Clock
+
+include(../bench.pri)
+
+SOURCES += \
+    bench_clock.cpp
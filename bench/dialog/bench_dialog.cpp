@@ -0,0 +1,170 @@
+// Cost of a FramelessDialog with the theme sheet shared through the
+// ThemeRegistry, and with a copy read and decoded for every dialog, which
+// is how each dialog loaded its sheet before the registry. Then the time
+// from opening a dialog to its first paint, for a dialog built on demand
+// and one taken from a warm FramelessDialogPool.
+//
+//     QT_QPA_PLATFORM=offscreen ./QWKBench_Dialog
+
+#include <algorithm>
+#include <memory>
+
+#include <QtCore/QElapsedTimer>
+#include <QtCore/QFile>
+#include <QtCore/QVector>
+
+#include "qwktest.h"
+#include "FramelessDialog.h"
+#include "framelessdialogpool.hpp"
+
+// Time of the first paint of a widget on a running timer
+class FirstPaint : public QObject {
+public:
+    FirstPaint(QWidget *widget, const QElapsedTimer &timer) : QObject(widget), m_timer(timer) {
+        widget->installEventFilter(this);
+    }
+
+    qint64 nsecs{-1};
+
+protected:
+    bool eventFilter(QObject *obj, QEvent *event) override {
+        if (event->type() == QEvent::Paint && nsecs < 0) {
+            nsecs = m_timer.nsecsElapsed();
+            obj->removeEventFilter(this);
+        }
+        return QObject::eventFilter(obj, event);
+    }
+
+private:
+    const QElapsedTimer &m_timer;
+};
+
+class bench_Dialog : public QObject {
+    Q_OBJECT
+
+private Q_SLOTS:
+    void initTestCase();
+
+    void construct_data();
+    void construct();
+
+    void openToFirstPaint_data();
+    void openToFirstPaint();
+
+private:
+    // The qss of a theme, read and decoded again on every call
+    static QString readStyleSheet(Theme theme) {
+        for (const QString &path : ThemeRegistry::styleSheetPaths(theme)) {
+            QFile qss(path);
+            if (qss.open(QIODevice::ReadOnly | QIODevice::Text))
+                return QString::fromUtf8(qss.readAll());
+        }
+        return {};
+    }
+
+    // A dialog ready to be shown. The private sheet replaces the shared one
+    // before the dialog is polished, so either sheet is parsed once.
+    static FramelessDialog *createDialog(QWidget *parent, bool privateSheet) {
+        auto dialog = new FramelessDialog(parent);
+        if (privateSheet) {
+            dialog->setStyleSheet(readStyleSheet(Dark));
+        }
+        dialog->ensurePolished();
+        dialog->layout()->activate();
+        return dialog;
+    }
+};
+
+void bench_Dialog::initTestCase() {
+    ThemeRegistry::instance()->setTheme(Dark);
+    // The registry loads the shared sheet outside of the measurements
+    delete createDialog(nullptr, false);
+}
+
+void bench_Dialog::construct_data() {
+    QTest::addColumn<bool>("privateSheet");
+
+    QTest::newRow("shared sheet") << false;
+    QTest::newRow("sheet per dialog") << true;
+}
+
+void bench_Dialog::construct() {
+    QFETCH(bool, privateSheet);
+    QWidget parent;
+
+    QBENCHMARK {
+        delete createDialog(&parent, privateSheet);
+    }
+
+    // Heap held by each of several dialogs alive at the same time
+    static constexpr const int dialogs = 20;
+    QVector<FramelessDialog *> alive;
+    const qint64 before = currentHeapBytes();
+    for (int i = 0; i < dialogs; ++i) {
+        alive.append(createDialog(&parent, privateSheet));
+    }
+    const qint64 after = currentHeapBytes();
+    qDeleteAll(alive);
+
+    if (before >= 0 && after >= 0) {
+        qInfo("%lld heap bytes per dialog", (after - before) / dialogs);
+    }
+}
+
+void bench_Dialog::openToFirstPaint_data() {
+    QTest::addColumn<bool>("pooled");
+
+    QTest::newRow("cold") << false;
+    QTest::newRow("pooled") << true;
+}
+
+void bench_Dialog::openToFirstPaint() {
+    QFETCH(bool, pooled);
+    static constexpr const int opens = 20;
+
+    QWidget parent;
+    parent.resize(800, 600);
+    parent.show();
+    QVERIFY(QTest::qWaitForWindowExposed(&parent));
+    std::unique_ptr<FramelessDialogPool> pool;
+    if (pooled) {
+        pool = std::make_unique<FramelessDialogPool>(&parent);
+    }
+
+    // From the click to the first paint, as the "custom dialog" action does
+    QVector<qint64> samples;
+    for (int i = 0; i < opens; ++i) {
+        if (pool) {
+            QTRY_COMPARE(pool->available(), 1);
+        }
+
+        QElapsedTimer timer;
+        timer.start();
+        FramelessDialog *dialog = pool ? pool->acquire() : new FramelessDialog(&parent);
+        auto label = new QLabel(QStringLiteral("Hello world"));
+        label->setAlignment(Qt::AlignCenter);
+        dialog->setWindowTitle(QStringLiteral("Help"));
+        dialog->setFixedSize(400, 240);
+        dialog->setCentralWidget(label);
+        auto paint = new FirstPaint(dialog, timer);
+        dialog->open();
+        QTRY_VERIFY(paint->nsecs >= 0);
+        samples.append(paint->nsecs);
+
+        delete paint;
+        if (pool) {
+            pool->release(dialog);
+        } else {
+            delete dialog;
+        }
+    }
+
+    std::sort(samples.begin(), samples.end());
+    const qint64 median = samples.at(samples.size() / 2);
+    QTest::setBenchmarkResult(median / 1e6, QTest::WalltimeMilliseconds);
+    qInfo("median %.2f ms, slowest %.2f ms", median / 1e6, samples.constLast() / 1e6);
+}
+
+QWK_TEST_MAIN(bench_Dialog)
+
+#include "bench_dialog.moc"
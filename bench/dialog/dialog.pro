@@ -0,0 +1,6 @@
+TARGET = QWKBench_Dialog
+
+include(../bench.pri)
+
+SOURCES += \
+    bench_dialog.cpp
@@ -0,0 +1,131 @@
+// Hit tests of the title bar along a mouse move, with 5, 50 and 200 tool
+// buttons in the bar, in groups of five. The agent's window context runs the
+// test on every mouse move: "every button" registers each button with the
+// agent directly, "hit-test map" goes through FramelessHelper, which gives
+// the agent the groups instead. "map lookup" is HitTestMap::hitTest().
+//
+//     QT_QPA_PLATFORM=offscreen ./QWKBench_HitTest
+
+#include <QtCore/QVector>
+#include <QtWidgets/QBoxLayout>
+#include <QtWidgets/QToolButton>
+
+#include "qwktest.h"
+#include "framelesshelper.hpp"
+
+class bench_HitTest : public QObject {
+    Q_OBJECT
+
+public:
+    enum Mode {
+        EveryButton,
+        Map,
+        MapLookup,
+    };
+    Q_ENUM(Mode)
+
+private Q_SLOTS:
+    void mouseMove_data();
+    void mouseMove();
+
+private:
+    // Tool buttons in groups of five, the buttons of a group touching
+    static QWidget *createTools(int buttons) {
+        auto tools = new QWidget();
+        auto layout = new QHBoxLayout(tools);
+        layout->setContentsMargins(0, 0, 0, 0);
+        layout->setSpacing(4);
+        QHBoxLayout *group = nullptr;
+        for (int i = 0; i < buttons; ++i) {
+            if (i % 5 == 0) {
+                auto groupWidget = new QWidget();
+                group = new QHBoxLayout(groupWidget);
+                group->setContentsMargins(0, 0, 0, 0);
+                group->setSpacing(0);
+                layout->addWidget(groupWidget);
+            }
+            auto button = new QToolButton();
+            button->setFixedSize(8, 24);
+            group->addWidget(button);
+        }
+        return tools;
+    }
+};
+
+void bench_HitTest::mouseMove_data() {
+    QTest::addColumn<Mode>("mode");
+    QTest::addColumn<int>("buttons");
+
+    const QPair<const char *, Mode> modes[] = {
+        {"every button", EveryButton},
+        {"hit-test map", Map},
+        {"map lookup", MapLookup},
+    };
+    for (const auto &mode : modes) {
+        for (int buttons : {5, 50, 200}) {
+            QTest::addRow("%s, %d buttons", mode.first, buttons) << mode.second << buttons;
+        }
+    }
+}
+
+void bench_HitTest::mouseMove() {
+    QFETCH(Mode, mode);
+    QFETCH(int, buttons);
+
+    QWidget host;
+    auto helper = new FramelessHelper(&host, Dark);
+    auto agent = host.findChild<QWK::WidgetWindowAgent *>();
+    QVERIFY(agent);
+    auto barLayout = qobject_cast<QBoxLayout *>(helper->titleBar()->layout());
+    QVERIFY(barLayout);
+    QWidget *tools = createTools(buttons);
+    barLayout->addWidget(tools);
+    for (auto button : tools->findChildren<QToolButton *>()) {
+        if (mode == EveryButton) {
+            agent->setHitTestVisible(button);
+        } else {
+            helper->setHitTestVisible(button);
+        }
+    }
+
+    auto layout = new QVBoxLayout(&host);
+    layout->setContentsMargins(0, 0, 0, 0);
+    layout->addWidget(helper->titleBar());
+    layout->addStretch();
+    host.resize(2400, 600);
+    host.show();
+    QVERIFY(QTest::qWaitForWindowExposed(&host));
+    QCoreApplication::processEvents();
+
+    // A move across the bar and back through the window below it
+    const QWidget *bar = helper->titleBar();
+    const int barY = bar->mapTo(&host, QPoint(0, bar->height() / 2)).y();
+    QVector<QPoint> path;
+    for (int x = 0; x < host.width(); x += 2) {
+        path.append(QPoint(x, barY));
+    }
+    for (int x = host.width() - 1; x >= 0; x -= 8) {
+        path.append(QPoint(x, host.height() / 2));
+    }
+
+    QWK::AbstractWindowContext *context = windowContext(agent);
+    int draggable = 0;
+    QBENCHMARK {
+        draggable = 0;
+        for (const QPoint &pos : std::as_const(path)) {
+            if (mode == MapLookup) {
+                draggable += helper->hitTest(pos).area == HitTestMap::Caption;
+            } else {
+                draggable += context->isInTitleBarDraggableArea(pos);
+            }
+        }
+    }
+
+    const int registered = mode == EveryButton ? buttons : helper->hitTestStats().registered;
+    qInfo("%d points, %d draggable, %d widgets registered with the agent", int(path.size()),
+          draggable, registered);
+}
+
+QWK_TEST_MAIN(bench_HitTest)
+
+#include "bench_hittest.moc"
@@ -0,0 +1,6 @@
+TARGET = QWKBench_HitTest
+
+include(../bench.pri)
+
+SOURCES += \
+    bench_hittest.cpp
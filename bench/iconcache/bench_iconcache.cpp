@@ -0,0 +1,210 @@
+// Time spent rasterizing the window-bar icons while five main windows are
+// shown, then while they are moved back and forth between two screens with
+// different device pixel ratios. "icon per button" gives every button icons
+// of its own, as the qproperty-iconNormal rules of the qss did; "shared
+// cache" is the IconCache.
+//
+//     QT_QPA_PLATFORM=offscreen ./QWKBench_IconCache
+//
+// The screen crossings need the two screens of the offscreen configuration
+// file, they are skipped where the platform does not take one.
+
+#include <memory>
+#include <vector>
+
+#include <QtCore/QElapsedTimer>
+#include <QtGui/QIconEngine>
+#include <QtGui/QScreen>
+
+#include "qwktest.h"
+#include "framelesswindow.h"
+
+// An icon of its own, timing its rasterization
+class TimedIconEngine : public QIconEngine {
+public:
+    explicit TimedIconEngine(const QString &path) : m_path(path), m_icon(path) {
+    }
+
+    static inline qint64 renderNs = 0;
+
+    void paint(QPainter *painter, const QRect &rect, QIcon::Mode mode,
+               QIcon::State state) override {
+        const qreal dpr = painter->device()->devicePixelRatioF();
+        painter->drawPixmap(rect, render(rect.size(), dpr, mode, state));
+    }
+
+    QPixmap pixmap(const QSize &size, QIcon::Mode mode, QIcon::State state) override {
+        return render(size, 1.0, mode, state);
+    }
+
+#if QT_VERSION >= QT_VERSION_CHECK(6, 0, 0)
+    QPixmap scaledPixmap(const QSize &size, QIcon::Mode mode, QIcon::State state,
+                         qreal scale) override {
+#if QT_VERSION >= QT_VERSION_CHECK(6, 8, 0)
+        return render(size, scale, mode, state);
+#else
+        // Before 6.8 the size is in device pixels
+        return render((QSizeF(size) / scale).toSize(), scale, mode, state);
+#endif
+    }
+#endif
+
+    QSize actualSize(const QSize &size, QIcon::Mode mode, QIcon::State state) override {
+        Q_UNUSED(mode);
+        Q_UNUSED(state);
+        return size;
+    }
+
+    QString key() const override {
+        return QStringLiteral("TimedIconEngine");
+    }
+
+    QIconEngine *clone() const override {
+        return new TimedIconEngine(m_path);
+    }
+
+private:
+    QPixmap render(const QSize &size, qreal dpr, QIcon::Mode mode, QIcon::State state) {
+        QElapsedTimer timer;
+        timer.start();
+#if QT_VERSION >= QT_VERSION_CHECK(6, 0, 0)
+        QPixmap pm = m_icon.pixmap(size, dpr, mode, state);
+#else
+        QPixmap pm = m_icon.pixmap(size * dpr, mode, state);
+        pm.setDevicePixelRatio(dpr);
+#endif
+        renderNs += timer.nsecsElapsed();
+        return pm;
+    }
+
+    QString m_path;
+    QIcon m_icon;
+};
+
+class bench_IconCache : public QObject {
+    Q_OBJECT
+
+private Q_SLOTS:
+    void startup_data();
+    void startup();
+
+    void acrossScreens_data();
+    void acrossScreens();
+
+private:
+    static constexpr const int windows = 5;
+
+    static void reset() {
+        IconCache::instance()->clear();
+        TimedIconEngine::renderNs = 0;
+    }
+
+    static qint64 renderNs(bool shared) {
+        return shared ? IconCache::instance()->stats().renderNs : TimedIconEngine::renderNs;
+    }
+
+    // Rasterization since the counts in before
+    static void report(bool shared, qint64 nsBefore = 0, const IconCache::Stats &before = {}) {
+        const qint64 ns = renderNs(shared) - nsBefore;
+        QTest::setBenchmarkResult(ns / 1e6, QTest::WalltimeMilliseconds);
+        if (shared) {
+            const IconCache::Stats stats = IconCache::instance()->stats();
+            qInfo("%.2f ms rasterizing, %d renders, %d cache hits", ns / 1e6,
+                  stats.renders - before.renders, stats.hits - before.hits);
+        } else {
+            qInfo("%.2f ms rasterizing", ns / 1e6);
+        }
+    }
+
+    // Main windows shown on screen, their buttons painted
+    static std::vector<std::unique_ptr<FramelessWindow>> showWindows(bool shared,
+                                                                      QScreen *screen) {
+        std::vector<std::unique_ptr<FramelessWindow>> result;
+        for (int i = 0; i < windows; ++i) {
+            auto window =
+                std::make_unique<FramelessWindow>(nullptr, QStringLiteral("bench-iconcache"));
+            window->move(screen->geometry().topLeft() + QPoint(50 + 20 * i, 50 + 20 * i));
+            // The title bar parts are built and given the cached icons on polish
+            window->ensurePolished();
+            if (!shared) {
+                for (auto button : window->findChildren<QWK::WindowButton *>()) {
+                    const WindowBarIcons icons = WindowBarIcons::forButton(button->objectName());
+                    if (icons.normal) {
+                        button->setIconNormal(
+                            QIcon(new TimedIconEngine(QString::fromLatin1(icons.normal))));
+                    }
+                    if (icons.checked) {
+                        button->setIconChecked(
+                            QIcon(new TimedIconEngine(QString::fromLatin1(icons.checked))));
+                    }
+                }
+            }
+            window->show();
+            if (!QTest::qWaitForWindowExposed(window.get()))
+                return {};
+            result.push_back(std::move(window));
+        }
+        QCoreApplication::processEvents();
+        return result;
+    }
+};
+
+void bench_IconCache::startup_data() {
+    QTest::addColumn<bool>("shared");
+
+    QTest::newRow("icon per button") << false;
+    QTest::newRow("shared cache") << true;
+}
+
+void bench_IconCache::startup() {
+    QFETCH(bool, shared);
+    reset();
+
+    const auto shown = showWindows(shared, QGuiApplication::primaryScreen());
+    QCOMPARE(int(shown.size()), windows);
+    report(shared);
+}
+
+void bench_IconCache::acrossScreens_data() {
+    startup_data();
+}
+
+void bench_IconCache::acrossScreens() {
+    QFETCH(bool, shared);
+    static constexpr const int crossings = 10;
+
+    const QList<QScreen *> screens = QGuiApplication::screens();
+    if (screens.size() < 2 ||
+        screens.at(0)->devicePixelRatio() == screens.at(1)->devicePixelRatio())
+        QSKIP("needs two screens with different device pixel ratios");
+
+    reset();
+    const auto shown = showWindows(shared, screens.at(0));
+    QCOMPARE(int(shown.size()), windows);
+    // Both ratios are rasterized on the first crossings only
+    const qint64 nsBefore = renderNs(shared);
+    const IconCache::Stats before = IconCache::instance()->stats();
+
+    for (int step = 1; step <= crossings; ++step) {
+        QScreen *screen = screens.at(step % 2);
+        for (const auto &window : shown) {
+            window->move(screen->geometry().topLeft() + QPoint(100, 100));
+            QTRY_COMPARE(window->screen(), screen);
+            window->repaint();
+        }
+    }
+    report(shared, nsBefore, before);
+}
+
+// Two screens with different ratios where the offscreen platform takes a
+// screen configuration
+int main(int argc, char *argv[]) {
+    if (qEnvironmentVariableIsEmpty("QT_QPA_PLATFORM"))
+        qputenv("QT_QPA_PLATFORM", QByteArrayLiteral("offscreen:configfile=") + SCREENS_CONFIG);
+    QStandardPaths::setTestModeEnabled(true);
+    QApplication app(argc, argv);
+    bench_IconCache bench;
+    return QTest::qExec(&bench, argc, argv);
+}
+
+#include "bench_iconcache.moc"
@@ -0,0 +1,9 @@
+TARGET = QWKBench_IconCache
+
+include(../bench.pri)
+
+SOURCES += \
+    bench_iconcache.cpp
+
+# 离屏平台的双屏配置，与 tests/screenchange 共用
+DEFINES += SCREENS_CONFIG=\\\"$$PWD/../../tests/screenchange/screens.json\\\"
@@ -0,0 +1,115 @@
+// Startup cost of a menu bar of 500 actions: 10 menus of 50 actions each,
+// every fifth one with a shortcut and the last five of a menu in a group.
+// "eager" creates every action up front, as the hand-written menus did;
+// "lazy" is the MenuModel default, which creates the actions of a menu the
+// first time it opens. One iteration builds and polishes the menu bar.
+//
+//     QT_QPA_PLATFORM=offscreen ./QWKBench_MenuModel
+
+#include <QtCore/QJsonArray>
+#include <QtCore/QJsonDocument>
+#include <QtCore/QJsonObject>
+#include <QtCore/QSet>
+#include <QtCore/QTemporaryDir>
+
+#include "qwktest.h"
+#include "menumodel.hpp"
+
+class bench_MenuModel : public QObject {
+    Q_OBJECT
+
+private Q_SLOTS:
+    void initTestCase();
+
+    void startup_data();
+    void startup();
+
+private:
+    static constexpr const int menus = 10;
+    static constexpr const int actionsPerMenu = 50;
+
+    // Opens every menu once, submenus included, without showing it
+    static void populateAll(QMenuBar *menuBar) {
+        QSet<QMenu *> populated;
+        for (bool added = true; added;) {
+            added = false;
+            for (QMenu *menu : menuBar->findChildren<QMenu *>()) {
+                if (populated.contains(menu))
+                    continue;
+                populated.insert(menu);
+                Q_EMIT menu->aboutToShow();
+                added = true;
+            }
+        }
+    }
+
+    QTemporaryDir m_dir;
+    QString m_path;
+};
+
+void bench_MenuModel::initTestCase() {
+    QVERIFY(m_dir.isValid());
+    QJsonArray menuArray;
+    for (int m = 0; m < menus; ++m) {
+        QJsonArray items;
+        for (int a = 0; a < actionsPerMenu; ++a) {
+            QJsonObject item{
+                {QStringLiteral("id"), QStringLiteral("action-%1-%2").arg(m).arg(a)},
+                {QStringLiteral("text"), QStringLiteral("Action %1").arg(a)},
+            };
+            if (a % 5 == 0) {
+                item.insert(QStringLiteral("shortcut"),
+                            QStringLiteral("Ctrl+Shift+%1").arg(a % 10));
+            }
+            if (a >= actionsPerMenu - 5) {
+                item.insert(QStringLiteral("group"), QStringLiteral("group-%1").arg(m));
+            }
+            items.append(item);
+        }
+        menuArray.append(QJsonObject{
+            {QStringLiteral("title"), QStringLiteral("Menu %1").arg(m)},
+            {QStringLiteral("items"), items},
+        });
+    }
+
+    m_path = m_dir.filePath(QStringLiteral("menus.json"));
+    QFile file(m_path);
+    QVERIFY(file.open(QIODevice::WriteOnly));
+    file.write(QJsonDocument(QJsonObject{{QStringLiteral("menus"), menuArray}}).toJson());
+}
+
+void bench_MenuModel::startup_data() {
+    QTest::addColumn<bool>("eager");
+
+    QTest::newRow("eager") << true;
+    QTest::newRow("lazy") << false;
+}
+
+void bench_MenuModel::startup() {
+    QFETCH(bool, eager);
+
+    QWidget host;
+    QBENCHMARK {
+        auto menuBar = new QMenuBar(&host);
+        new MenuModel(m_path, menuBar, "bench_MenuModel");
+        if (eager) {
+            populateAll(menuBar);
+        }
+        menuBar->ensurePolished();
+        menuBar->adjustSize();
+        delete menuBar;
+    }
+
+    auto menuBar = new QMenuBar(&host);
+    auto model = new MenuModel(m_path, menuBar, "bench_MenuModel");
+    if (eager) {
+        populateAll(menuBar);
+    }
+    qInfo("%d objects, %d actions created", 1 + int(menuBar->findChildren<QObject *>().size()),
+          model->actionCount());
+    delete menuBar;
+}
+
+QWK_TEST_MAIN(bench_MenuModel)
+
+#include "bench_menumodel.moc"
@@ -0,0 +1,6 @@
+TARGET = QWKBench_MenuModel
+
+include(../bench.pri)
+
+SOURCES += \
+    bench_menumodel.cpp
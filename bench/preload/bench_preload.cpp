@@ -0,0 +1,71 @@
+// Time to the first frame of the main window with and without the
+// StartupPreloader. Every run is a fresh QWKBench_Startup process, the
+// second row sets QWK_NO_PRELOAD; the median of the runs is reported.
+//
+//     QT_QPA_PLATFORM=offscreen ./QWKBench_Preload
+
+#include <algorithm>
+
+#include <QtCore/QJsonDocument>
+#include <QtCore/QJsonObject>
+#include <QtCore/QProcess>
+#include <QtCore/QVector>
+
+#include "qwktest.h"
+
+class bench_Preload : public QObject {
+    Q_OBJECT
+
+private Q_SLOTS:
+    void firstFrame_data();
+    void firstFrame();
+
+private:
+    // first_frame_ms of one startup, -1 if the process failed
+    static double startup(bool preload) {
+        QProcessEnvironment environment = QProcessEnvironment::systemEnvironment();
+        if (!preload) {
+            environment.insert(QStringLiteral("QWK_NO_PRELOAD"), QStringLiteral("1"));
+        }
+        QProcess process;
+        process.setProcessEnvironment(environment);
+        process.start(QStringLiteral(STARTUP_BENCH), {QStringLiteral("-")});
+        if (!process.waitForFinished(30000) || process.exitStatus() != QProcess::NormalExit ||
+            process.exitCode() != 0)
+            return -1;
+        const QJsonObject result = QJsonDocument::fromJson(process.readAllStandardOutput()).object();
+        return result.value(QStringLiteral("first_frame_ms")).toDouble(-1);
+    }
+};
+
+void bench_Preload::firstFrame_data() {
+    QTest::addColumn<bool>("preload");
+
+    QTest::newRow("preload") << true;
+    QTest::newRow("no preload") << false;
+}
+
+void bench_Preload::firstFrame() {
+    QFETCH(bool, preload);
+    static constexpr const int runs = 15;
+
+    // The first start warms the disk cache
+    QVERIFY2(startup(preload) >= 0, STARTUP_BENCH);
+
+    QVector<double> samples;
+    for (int i = 0; i < runs; ++i) {
+        const double ms = startup(preload);
+        QVERIFY(ms >= 0);
+        samples.append(ms);
+    }
+
+    std::sort(samples.begin(), samples.end());
+    const double median = samples.at(samples.size() / 2);
+    QTest::setBenchmarkResult(median, QTest::WalltimeMilliseconds);
+    qInfo("median %.2f ms, fastest %.2f ms, slowest %.2f ms", median, samples.constFirst(),
+          samples.constLast());
+}
+
+QWK_TEST_MAIN(bench_Preload)
+
+#include "bench_preload.moc"
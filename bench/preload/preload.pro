@@ -0,0 +1,18 @@
+TARGET = QWKBench_Preload
+
+include(../bench.pri)
+
+SOURCES += \
+    bench_preload.cpp
+
+# 被测的启动基准程序，见 bench/startup
+win32 {
+    CONFIG(debug, debug|release) {
+        STARTUP_BENCH = $$OUT_PWD/../startup/debug/QWKBench_Startup.exe
+    } else {
+        STARTUP_BENCH = $$OUT_PWD/../startup/release/QWKBench_Startup.exe
+    }
+} else {
+    STARTUP_BENCH = $$OUT_PWD/../startup/QWKBench_Startup
+}
+DEFINES += STARTUP_BENCH=\\\"$$STARTUP_BENCH\\\"
@@ -0,0 +1,75 @@
+#ifndef QWKBENCH_H
+#define QWKBENCH_H
+
+#include <QtCore/QtGlobal>
+
+#if defined(Q_OS_WIN)
+#  include <qt_windows.h>
+#  include <psapi.h>
+#else
+#  include <sys/resource.h>
+#  include <unistd.h>
+#endif
+#if defined(Q_OS_MAC)
+#  include <mach/mach.h>
+#endif
+#if defined(Q_OS_LINUX)
+#  include <cstdio>
+#endif
+
+// CPU time used by the process so far, user and system, in nanoseconds.
+// -1 if the platform does not tell.
+inline qint64 processCpuNs() {
+#if defined(Q_OS_WIN)
+    FILETIME creation, exit, kernel, user;
+    if (!GetProcessTimes(GetCurrentProcess(), &creation, &exit, &kernel, &user))
+        return -1;
+    // 100 ns units
+    auto ticks = [](const FILETIME &time) {
+        return qint64(time.dwHighDateTime) << 32 | qint64(time.dwLowDateTime);
+    };
+    return (ticks(kernel) + ticks(user)) * 100;
+#else
+    rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) != 0)
+        return -1;
+    auto nsecs = [](const timeval &time) {
+        return qint64(time.tv_sec) * 1000000000 + qint64(time.tv_usec) * 1000;
+    };
+    return nsecs(usage.ru_utime) + nsecs(usage.ru_stime);
+#endif
+}
+
+// Resident set size of the process, in bytes. -1 if the platform does not
+// tell.
+inline qint64 processRssBytes() {
+#if defined(Q_OS_WIN)
+    PROCESS_MEMORY_COUNTERS counters;
+    if (!GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters)))
+        return -1;
+    return qint64(counters.WorkingSetSize);
+#elif defined(Q_OS_MAC)
+    mach_task_basic_info info;
+    mach_msg_type_number_t count = MACH_TASK_BASIC_INFO_COUNT;
+    if (task_info(mach_task_self(), MACH_TASK_BASIC_INFO, task_info_t(&info), &count) !=
+        KERN_SUCCESS)
+        return -1;
+    return qint64(info.resident_size);
+#elif defined(Q_OS_LINUX)
+    // Pages, the second field is the resident set
+    FILE *statm = std::fopen("/proc/self/statm", "r");
+    if (!statm)
+        return -1;
+    long size = 0;
+    long resident = 0;
+    const int fields = std::fscanf(statm, "%ld %ld", &size, &resident);
+    std::fclose(statm);
+    if (fields != 2)
+        return -1;
+    return qint64(resident) * sysconf(_SC_PAGESIZE);
+#else
+    return -1;
+#endif
+}
+
+#endif // QWKBENCH_H
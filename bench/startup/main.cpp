@@ -0,0 +1,68 @@
+// Copyright (C) 2023-2024 Stdware Collections (https://www.github.com/stdware)
+// Copyright (C) 2021-2023 wangwenx190 (Yuhang Zhao)
+// SPDX-License-Identifier: Apache-2.0
+
+// Startup benchmark: builds the main window the way the application does and
+// writes the startup phases up to the first frame as JSON, then quits.
+//
+//     QT_QPA_PLATFORM=offscreen ./QWKBench_Startup [output.json]
+//
+// Without an output file the results go to stdout. The dialog pool warms up
+// right after the first frame, its "dialog-warmup" phase is included. The
+// window starts from the default state: saved states are read from and
+// written to the test locations, never the user's.
+
+#include <QtCore/QStandardPaths>
+#include <QtCore/QTimer>
+#include <QtGui/QScreen>
+#include <QtWidgets/QApplication>
+
+#include "framelesswindow.h"
+#include "startupprofiler.hpp"
+#include "startuppreloader.hpp"
+
+int main(int argc, char *argv[]) {
+#if QT_VERSION >= QT_VERSION_CHECK(5, 14, 0)
+    QGuiApplication::setHighDpiScaleFactorRoundingPolicy(
+        Qt::HighDpiScaleFactorRoundingPolicy::PassThrough);
+#endif
+#if QT_VERSION < QT_VERSION_CHECK(6, 0, 0)
+    QCoreApplication::setAttribute(Qt::AA_EnableHighDpiScaling);
+    QCoreApplication::setAttribute(Qt::AA_UseHighDpiPixmaps);
+#endif
+
+    QCoreApplication::setAttribute(Qt::AA_DontCreateNativeWidgetSiblings);
+
+    QStandardPaths::setTestModeEnabled(true);
+
+    StartupProfiler::start();
+    QApplication a(argc, argv);
+    StartupProfiler::record("application", 0, StartupProfiler::now());
+
+    const QStringList arguments = QCoreApplication::arguments();
+    const QString target = arguments.size() > 1 ? arguments.at(1) : QStringLiteral("-");
+
+    StartupPreloader::start(
+        ThemeRegistry::styleSheetPaths(Dark) + ThemeRegistry::styleSheetPaths(Light),
+        WindowBarIcons::startupImages(), QGuiApplication::primaryScreen()->devicePixelRatio());
+
+    FramelessWindow *w;
+    {
+        StartupPhase phase("construct");
+        w = new FramelessWindow(nullptr, QStringLiteral("bench-startup"));
+    }
+    StartupProfiler::watch(w, [target]() {
+        // Queued behind the warm-up the first frame has started
+        QTimer::singleShot(0, [target]() {
+            QCoreApplication::exit(StartupProfiler::finish(target) ? 0 : 1);
+        });
+    });
+    {
+        StartupPhase phase("show");
+        w->show();
+    }
+
+    const int result = a.exec();
+    delete w;
+    return result;
+}
@@ -0,0 +1,11 @@
+#-------------------------------------------------#
+# 启动基准：测量主窗口到首帧的各阶段耗时          #
+#-------------------------------------------------#
+
+TARGET = QWKBench_Startup
+
+include(../bench.pri)
+
+# 源文件
+SOURCES += \
+    main.cpp
@@ -0,0 +1,75 @@
+// Theme switch latency of a frameless window with a large central area, for
+// the two style sheet paths and the native theme engine. One iteration is a
+// switch to the other theme up to the repainted window: the theme change, the
+// relayouts it posts and a synchronous repaint.
+//
+//     QT_QPA_PLATFORM=offscreen ./QWKBench_ThemeSwitch
+
+#include <QtWidgets/QVBoxLayout>
+
+#include "qwktest.h"
+#include "framelesshelper.hpp"
+
+Q_DECLARE_METATYPE(ThemeMode)
+
+class bench_ThemeSwitch : public QObject {
+    Q_OBJECT
+
+private Q_SLOTS:
+    void switchTheme_data();
+    void switchTheme();
+};
+
+void bench_ThemeSwitch::switchTheme_data() {
+    QTest::addColumn<ThemeMode>("mode");
+    QTest::addColumn<int>("widgets");
+
+    const QPair<const char *, ThemeMode> modes[] = {
+        {"qss", ThemeMode::StyleSheet},
+        {"incremental qss", ThemeMode::IncrementalStyleSheet},
+        {"native", ThemeMode::Native},
+    };
+    for (const auto &mode : modes) {
+        for (int widgets : {100, 1000, 10000}) {
+            QTest::addRow("%s, %d widgets", mode.first, widgets) << mode.second << widgets;
+        }
+    }
+}
+
+void bench_ThemeSwitch::switchTheme() {
+    QFETCH(ThemeMode, mode);
+    QFETCH(int, widgets);
+
+    ThemeRegistry *registry = ThemeRegistry::instance();
+    registry->setTheme(Dark);
+
+    QWidget host;
+    auto helper = new FramelessHelper(&host, Dark, mode);
+    auto layout = new QVBoxLayout(&host);
+    layout->setContentsMargins(0, 0, 0, 0);
+    layout->addWidget(helper->titleBar());
+    auto area = new QWidget();
+    addLabels(area, widgets);
+    layout->addWidget(area, 1);
+    host.resize(1200, 800);
+    host.show();
+    QVERIFY(QTest::qWaitForWindowExposed(&host));
+
+    Theme theme = Dark;
+    QBENCHMARK {
+        theme = theme == Dark ? Light : Dark;
+        registry->setTheme(theme);
+        QCoreApplication::processEvents();
+        host.repaint();
+    }
+    QCOMPARE(helper->getTheme(), theme);
+
+    if (mode != ThemeMode::Native) {
+        qInfo("%d of %d widgets repolished per switch", helper->lastThemeSwitch().repolished,
+              int(host.findChildren<QWidget *>().size()) + 1);
+    }
+}
+
+QWK_TEST_MAIN(bench_ThemeSwitch)
+
+#include "bench_themeswitch.moc"
@@ -0,0 +1,6 @@
+TARGET = QWKBench_ThemeSwitch
+
+include(../bench.pri)
+
+SOURCES += \
+    bench_themeswitch.cpp
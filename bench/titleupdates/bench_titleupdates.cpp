@@ -0,0 +1,132 @@
+// 10,000 progress titles set on a window with a menu bar and system buttons,
+// the event loop running between two titles. "label text" is the window bar
+// mirroring the window title into a plain QLabel, as before TitleLabel;
+// "title label" is FramelessHelper::setTitle() without a rate limit and
+// "title label, 16 ms" with one. Reported are the GUI thread time of the
+// whole run and the layout requests the title bar and the window received.
+//
+//     QT_QPA_PLATFORM=offscreen ./QWKBench_TitleUpdates
+
+#include <memory>
+
+#include <QtCore/QElapsedTimer>
+#include <QtWidgets/QMenuBar>
+#include <QtWidgets/QVBoxLayout>
+
+#include "qwktest.h"
+#include "framelesshelper.hpp"
+
+// Counts the layout requests of the widgets it watches
+class LayoutCounter : public QObject {
+public:
+    void watch(QWidget *widget) {
+        widget->installEventFilter(this);
+    }
+
+    int layouts{0};
+
+protected:
+    bool eventFilter(QObject *obj, QEvent *event) override {
+        if (event->type() == QEvent::LayoutRequest) {
+            ++layouts;
+        }
+        return QObject::eventFilter(obj, event);
+    }
+};
+
+class bench_TitleUpdates : public QObject {
+    Q_OBJECT
+
+public:
+    enum Mode {
+        PlainLabel,
+        Unlimited,
+        RateLimited,
+    };
+    Q_ENUM(Mode)
+
+private Q_SLOTS:
+    void titles_data();
+    void titles();
+
+private:
+    static QMenuBar *createMenuBar() {
+        auto menuBar = new QMenuBar();
+        for (const char *title : {"File", "Edit", "View", "Help"}) {
+            menuBar->addMenu(QString::fromLatin1(title));
+        }
+        return menuBar;
+    }
+};
+
+void bench_TitleUpdates::titles_data() {
+    QTest::addColumn<Mode>("mode");
+
+    QTest::newRow("label text") << PlainLabel;
+    QTest::newRow("title label") << Unlimited;
+    QTest::newRow("title label, 16 ms") << RateLimited;
+}
+
+void bench_TitleUpdates::titles() {
+    QFETCH(Mode, mode);
+    static constexpr const int titles = 10000;
+
+    QWidget host;
+    auto layout = new QVBoxLayout(&host);
+    layout->setContentsMargins(0, 0, 0, 0);
+    FramelessHelper *helper = nullptr;
+    QWidget *bar = nullptr;
+    if (mode == PlainLabel) {
+        auto windowBar = new QWK::WindowBar();
+        auto label = new QLabel();
+        label->setAlignment(Qt::AlignCenter);
+        windowBar->setTitleLabel(label);
+        windowBar->setMenuBar(createMenuBar());
+        windowBar->setMinButton(new QWK::WindowButton());
+        windowBar->setMaxButton(new QWK::WindowButton());
+        windowBar->setCloseButton(new QWK::WindowButton());
+        windowBar->setHostWidget(&host);
+        bar = windowBar;
+    } else {
+        helper = new FramelessHelper(&host, Dark);
+        helper->setMenuBar(createMenuBar());
+        helper->setTitleUpdateInterval(mode == RateLimited ? 16 : 0);
+        bar = helper->titleBar();
+    }
+    layout->addWidget(bar);
+    layout->addStretch();
+    host.resize(1000, 600);
+    host.show();
+    QVERIFY(QTest::qWaitForWindowExposed(&host));
+    QCoreApplication::processEvents();
+
+    LayoutCounter counter;
+    counter.watch(&host);
+    counter.watch(bar);
+    QElapsedTimer timer;
+    timer.start();
+    for (int i = 0; i < titles; ++i) {
+        const QString title = QStringLiteral("Copying files, %1% done").arg(i % 100);
+        if (helper) {
+            helper->setTitle(title);
+        } else {
+            host.setWindowTitle(title);
+        }
+        QCoreApplication::processEvents();
+    }
+    QCoreApplication::processEvents();
+    const qint64 ns = timer.nsecsElapsed();
+
+    QTest::setBenchmarkResult(ns / 1e6, QTest::WalltimeMilliseconds);
+    if (helper) {
+        const TitleUpdater::Stats stats = helper->titleUpdateStats();
+        qInfo("%.1f ms, %d layout requests, %d of %d titles shown", ns / 1e6, counter.layouts,
+              stats.applied, stats.requests);
+    } else {
+        qInfo("%.1f ms, %d layout requests", ns / 1e6, counter.layouts);
+    }
+}
+
+QWK_TEST_MAIN(bench_TitleUpdates)
+
+#include "bench_titleupdates.moc"
@@ -0,0 +1,6 @@
+TARGET = QWKBench_TitleUpdates
+
+include(../bench.pri)
+
+SOURCES += \
+    bench_titleupdates.cpp
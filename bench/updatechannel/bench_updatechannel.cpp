@@ -0,0 +1,129 @@
+// GUI latency while 4 worker threads report progress as fast as they can,
+// 20,000 updates each, to a label on the GUI thread. "queued connection"
+// invokes a slot on the GUI thread for every update; "update channel" posts
+// to an UpdateChannel, delivered once per frame. Reported are how late a
+// 5 ms heartbeat timer of the GUI thread fires while the updates arrive,
+// the time from a post to its delivery and the deliveries themselves.
+//
+//     QT_QPA_PLATFORM=offscreen ./QWKBench_UpdateChannel
+
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <vector>
+
+#include <QtCore/QElapsedTimer>
+#include <QtCore/QThread>
+#include <QtCore/QTimer>
+#include <QtCore/QVector>
+
+#include "qwktest.h"
+#include "updatechannel.hpp"
+
+// One progress update and when it was posted
+struct Progress {
+    int value{0};
+    qint64 postedNs{0};
+};
+Q_DECLARE_METATYPE(Progress)
+
+class bench_UpdateChannel : public QObject {
+    Q_OBJECT
+
+private Q_SLOTS:
+    void latency_data();
+    void latency();
+};
+
+void bench_UpdateChannel::latency_data() {
+    QTest::addColumn<bool>("channel");
+
+    QTest::newRow("queued connection") << false;
+    QTest::newRow("update channel") << true;
+}
+
+void bench_UpdateChannel::latency() {
+    QFETCH(bool, channel);
+    static constexpr const int producers = 4;
+    static constexpr const int updates = 20000;
+    static constexpr const int heartbeatMs = 5;
+
+    QLabel label;
+    label.resize(300, 50);
+    label.show();
+    QVERIFY(QTest::qWaitForWindowExposed(&label));
+
+    QElapsedTimer clock;
+    clock.start();
+    QVector<int> last(producers, -1);
+    int deliveries = 0;
+    qint64 maxLatencyNs = 0;
+    auto deliver = [&](int producer, const Progress &progress) {
+        maxLatencyNs = qMax(maxLatencyNs, clock.nsecsElapsed() - progress.postedNs);
+        last[producer] = progress.value;
+        label.setText(QStringLiteral("%1: %2%").arg(producer).arg(progress.value * 100 / updates));
+        ++deliveries;
+    };
+
+    UpdateChannel updateChannel(&label);
+    for (int p = 0; p < producers; ++p) {
+        updateChannel.bind(QString::number(p), [&deliver, p](const QVariant &value) {
+            deliver(p, value.value<Progress>());
+        });
+    }
+
+    // How late each heartbeat fires
+    QVector<qint64> lateness;
+    qint64 lastBeat = clock.nsecsElapsed();
+    QTimer heartbeat;
+    heartbeat.setTimerType(Qt::PreciseTimer);
+    connect(&heartbeat, &QTimer::timeout, &label, [&]() {
+        const qint64 beat = clock.nsecsElapsed();
+        lateness.append(qMax<qint64>(0, beat - lastBeat - heartbeatMs * 1000000));
+        lastBeat = beat;
+    });
+    heartbeat.start(heartbeatMs);
+
+    std::atomic<int> running{producers};
+    std::vector<std::unique_ptr<QThread>> threads;
+    for (int p = 0; p < producers; ++p) {
+        threads.emplace_back(QThread::create([&, p]() {
+            const QString key = QString::number(p);
+            for (int i = 0; i < updates; ++i) {
+                const Progress progress{i, clock.nsecsElapsed()};
+                if (channel) {
+                    updateChannel.post(key, QVariant::fromValue(progress));
+                } else {
+                    QMetaObject::invokeMethod(
+                        &label, [&deliver, p, progress]() { deliver(p, progress); },
+                        Qt::QueuedConnection);
+                }
+            }
+            running.fetch_sub(1);
+        }));
+        threads.back()->start();
+    }
+
+    const qint64 start = clock.nsecsElapsed();
+    QTRY_VERIFY_WITH_TIMEOUT(running.load() == 0 &&
+                                 std::all_of(last.cbegin(), last.cend(),
+                                             [](int value) { return value == updates - 1; }),
+                             60000);
+    const qint64 ns = clock.nsecsElapsed() - start;
+    heartbeat.stop();
+    for (auto &thread : threads) {
+        QVERIFY(thread->wait(5000));
+    }
+
+    std::sort(lateness.begin(), lateness.end());
+    const qint64 maxLate = lateness.isEmpty() ? 0 : lateness.constLast();
+    const qint64 medianLate = lateness.isEmpty() ? 0 : lateness.at(lateness.size() / 2);
+    QTest::setBenchmarkResult(maxLate / 1e6, QTest::WalltimeMilliseconds);
+    qInfo("heartbeat late by %.2f ms at most, %.2f ms median; %d deliveries in %.1f ms, "
+          "%.2f ms from post to delivery at most",
+          maxLate / 1e6, medianLate / 1e6, deliveries, ns / 1e6, maxLatencyNs / 1e6);
+}
+
+QWK_TEST_MAIN(bench_UpdateChannel)
+
+#include "bench_updatechannel.moc"
@@ -0,0 +1,6 @@
+TARGET = QWKBench_UpdateChannel
+
+include(../bench.pri)
+
+SOURCES += \
+    bench_updatechannel.cpp
@@ -0,0 +1,80 @@
+// Cost of many frameless main windows open at once: the resident memory each
+// window adds, and the time to dispatch an event to a window. The event is
+// one no widget handles, so the time is the dispatch itself, through the
+// event filters of the FramelessWindowManager and the window agent.
+//
+//     QT_QPA_PLATFORM=offscreen ./QWKBench_Windows
+
+#include <memory>
+#include <vector>
+
+#include "qwktest.h"
+#include "qwkbench.h"
+#include "framelesswindow.h"
+
+class bench_Windows : public QObject {
+    Q_OBJECT
+
+private Q_SLOTS:
+    void initTestCase();
+
+    void windows_data();
+    void windows();
+};
+
+void bench_Windows::initTestCase() {
+    // Resources shared by all windows are loaded outside of the measurements
+    FramelessWindow window(nullptr, QStringLiteral("bench-windows"));
+    window.show();
+    QVERIFY(QTest::qWaitForWindowExposed(&window));
+}
+
+void bench_Windows::windows_data() {
+    QTest::addColumn<int>("count");
+
+    for (int count : {10, 100, 500}) {
+        QTest::addRow("%d windows", count) << count;
+    }
+}
+
+void bench_Windows::windows() {
+    QFETCH(int, count);
+
+    const qint64 rssBefore = processRssBytes();
+    const qint64 heapBefore = currentHeapBytes();
+    std::vector<std::unique_ptr<FramelessWindow>> windows;
+    for (int i = 0; i < count; ++i) {
+        auto window = std::make_unique<FramelessWindow>(nullptr, QStringLiteral("bench-windows"));
+        window->show();
+        windows.push_back(std::move(window));
+    }
+    QVERIFY(QTest::qWaitForWindowExposed(windows.back().get()));
+    QCoreApplication::processEvents();
+    const qint64 rssAfter = processRssBytes();
+    const qint64 heapAfter = currentHeapBytes();
+
+    QVector<QObject *> receivers;
+    for (const auto &window : windows) {
+        receivers.append(window.get());
+        receivers.append(window->findChild<QWK::WindowBar *>());
+    }
+    QBENCHMARK {
+        for (QObject *receiver : std::as_const(receivers)) {
+            QEvent event(QEvent::User);
+            QCoreApplication::sendEvent(receiver, &event);
+        }
+    }
+
+    if (rssBefore >= 0 && rssAfter >= 0) {
+        qInfo("%lld resident bytes per window", (rssAfter - rssBefore) / count);
+    }
+    if (heapBefore >= 0 && heapAfter >= 0) {
+        qInfo("%lld heap bytes per window", (heapAfter - heapBefore) / count);
+    }
+    qInfo("%d windows managed, %d events per iteration",
+          FramelessWindowManager::instance()->windowCount(), int(receivers.size()));
+}
+
+QWK_TEST_MAIN(bench_Windows)
+
+#include "bench_windows.moc"
@@ -0,0 +1,6 @@
+TARGET = QWKBench_Windows
+
+include(../bench.pri)
+
+SOURCES += \
+    bench_windows.cpp
@@ -0,0 +1,503 @@
+#ifndef EVENTRECORDER_H
+#define EVENTRECORDER_H
+
+#include <algorithm>
+#include <functional>
+
+#include <QObject>
+#include <QPointer>
+#include <QWidget>
+#include <QWindow>
+#include <QFile>
+#include <QTimer>
+#include <QVector>
+#include <QBuffer>
+#include <QDataStream>
+#include <QElapsedTimer>
+#include <QMouseEvent>
+#include <QWheelEvent>
+#include <QKeyEvent>
+#include <QJsonArray>
+#include <QJsonObject>
+#include <QJsonDocument>
+#include <QApplication>
+#include <QAbstractEventDispatcher>
+
+// Input and window-state events of a frameless window, recorded with their
+// timestamps into a compact binary file and replayed deterministically.
+//
+// Input is taken where the platform delivers it, at the QWindow of the host
+// or of the open popup menu, so a replay goes through the same widget
+// dispatch, hover tracking and mouse grabs as the real session. Resizes,
+// moves and window state changes of the host are recorded as well, since
+// some come from outside the recorded input (window manager, snapping). Most
+// come from the input itself: the replayed input produces them again. Each
+// one is only applied through the QWidget API if the host does not already
+// have that size, position or state when it is due. The replay runs at the
+// recorded pace or as fast as possible and measures for every event the time
+// from its dispatch until the event loop is idle again (or the next event is
+// due), layouts and paints included.
+//
+//     QWK_RECORD_EVENTS=session.qwkr ./QWKExample_MainWindow
+//     QT_QPA_PLATFORM=offscreen QWK_REPLAY_EVENTS=session.qwkr QWK_REPLAY_SPEED=max \
+//         QWK_REPLAY_REPORT=latency.json ./QWKExample_MainWindow
+namespace EventRecording {
+    static constexpr const quint32 Magic = 0x51574B52; // "QWKR"
+    static constexpr const quint8 Version = 1;
+
+    enum Target : quint8 {
+        Host,
+        Popup,
+    };
+
+    // QWindow the input of the target goes to, nullptr if it is not open
+    static inline QWindow *targetWindow(QWidget *host, Target target) {
+        QWidget *widget = target == Host ? host : QApplication::activePopupWidget();
+        return widget ? widget->windowHandle() : nullptr;
+    }
+
+    static inline void prepare(QDataStream &stream) {
+        stream.setVersion(QDataStream::Qt_5_15);
+        stream.setFloatingPointPrecision(QDataStream::SinglePrecision);
+    }
+}
+
+class EventRecorder : public QObject {
+public:
+    explicit EventRecorder(QWidget *host) : QObject(host), m_host(host), m_stream(&m_buffer) {
+        m_buffer.open(QIODevice::WriteOnly);
+        EventRecording::prepare(m_stream);
+        m_stream << EventRecording::Magic << EventRecording::Version << host->size()
+                 << quint32(host->windowState());
+
+        m_clock.start();
+        QCoreApplication::instance()->installEventFilter(this);
+    }
+
+    // Starts recording the window if QWK_RECORD_EVENTS is set, the file is
+    // written when the application quits
+    static void startFromEnvironment(QWidget *host) {
+        const QString path = qEnvironmentVariable("QWK_RECORD_EVENTS");
+        if (path.isEmpty())
+            return;
+        auto recorder = new EventRecorder(host);
+        QObject::connect(QCoreApplication::instance(), &QCoreApplication::aboutToQuit, recorder,
+                         [recorder, path]() { recorder->save(path); });
+    }
+
+    int eventCount() const {
+        return m_count;
+    }
+
+    bool save(const QString &path) const {
+        QFile file(path);
+        if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+            qWarning("EventRecorder: cannot write %s", qPrintable(path));
+            return false;
+        }
+        return file.write(m_buffer.data()) == m_buffer.size();
+    }
+
+protected:
+    bool eventFilter(QObject *obj, QEvent *event) override {
+        if (!m_host)
+            return false;
+
+        if (obj == m_host) {
+            switch (event->type()) {
+                case QEvent::Resize:
+                    begin(event, EventRecording::Host);
+                    m_stream << static_cast<QResizeEvent *>(event)->size();
+                    break;
+                case QEvent::Move:
+                    begin(event, EventRecording::Host);
+                    m_stream << static_cast<QMoveEvent *>(event)->pos();
+                    break;
+                case QEvent::WindowStateChange:
+                    begin(event, EventRecording::Host);
+                    m_stream << quint32(m_host->windowState());
+                    break;
+                default:
+                    break;
+            }
+            return false;
+        }
+
+        if (!obj->isWindowType())
+            return false;
+        EventRecording::Target target;
+        if (obj == EventRecording::targetWindow(m_host, EventRecording::Host)) {
+            target = EventRecording::Host;
+        } else if (obj == EventRecording::targetWindow(m_host, EventRecording::Popup)) {
+            target = EventRecording::Popup;
+        } else {
+            return false;
+        }
+
+        switch (event->type()) {
+            case QEvent::MouseButtonPress:
+            case QEvent::MouseButtonRelease:
+            case QEvent::MouseButtonDblClick:
+            case QEvent::MouseMove: {
+                auto e = static_cast<QMouseEvent *>(event);
+                begin(event, target);
+#if QT_VERSION >= QT_VERSION_CHECK(6, 0, 0)
+                m_stream << e->position();
+#else
+                m_stream << e->localPos();
+#endif
+                m_stream << quint32(e->button()) << quint32(e->buttons()) << quint32(e->modifiers());
+                break;
+            }
+            case QEvent::Wheel: {
+                auto e = static_cast<QWheelEvent *>(event);
+                begin(event, target);
+                m_stream << e->position() << e->pixelDelta() << e->angleDelta()
+                         << quint32(e->buttons()) << quint32(e->modifiers()) << quint32(e->phase())
+                         << e->inverted();
+                break;
+            }
+            case QEvent::KeyPress:
+            case QEvent::KeyRelease: {
+                auto e = static_cast<QKeyEvent *>(event);
+                begin(event, target);
+                m_stream << qint32(e->key()) << quint32(e->modifiers()) << e->text() << e->isAutoRepeat();
+                break;
+            }
+            case QEvent::Enter: {
+                begin(event, target);
+#if QT_VERSION >= QT_VERSION_CHECK(6, 0, 0)
+                m_stream << static_cast<QEnterEvent *>(event)->position();
+#else
+                m_stream << static_cast<QEnterEvent *>(event)->localPos();
+#endif
+                break;
+            }
+            case QEvent::Leave:
+                begin(event, target);
+                break;
+            default:
+                break;
+        }
+        return false;
+    }
+
+private:
+    void begin(const QEvent *event, EventRecording::Target target) {
+        m_stream << m_clock.nsecsElapsed() << quint16(event->type()) << quint8(target);
+        ++m_count;
+    }
+
+    QPointer<QWidget> m_host;
+    QBuffer m_buffer;
+    QDataStream m_stream;
+    QElapsedTimer m_clock;
+    int m_count{0};
+};
+
+class EventReplayer : public QObject {
+public:
+    struct Sample {
+        QEvent::Type type;
+        qint64 latencyNs;
+    };
+
+    struct Report {
+        int events{0};
+        // Events whose target window was not open at their time
+        int skipped{0};
+        // Geometry and state changes the replayed input had already made
+        int produced{0};
+        qint64 totalNs{0};
+        QVector<Sample> samples;
+
+        qint64 percentile(double p) const {
+            if (samples.isEmpty())
+                return 0;
+            QVector<qint64> latencies;
+            latencies.reserve(samples.size());
+            for (const Sample &sample : samples) {
+                latencies.append(sample.latencyNs);
+            }
+            std::sort(latencies.begin(), latencies.end());
+            return latencies.at(qMin(latencies.size() - 1, int(p * latencies.size())));
+        }
+    };
+
+    // speed 1.0 keeps the recorded timing, 0 replays as fast as possible
+    EventReplayer(QWidget *host, qreal speed, std::function<void(const Report &)> onFinished)
+        : QObject(host), m_host(host), m_speed(speed), m_onFinished(std::move(onFinished)) {
+        m_timer.setSingleShot(true);
+        m_timer.setTimerType(Qt::PreciseTimer);
+        connect(&m_timer, &QTimer::timeout, this, [this]() { dispatchNext(); });
+        if (auto dispatcher = QAbstractEventDispatcher::instance()) {
+            connect(dispatcher, &QAbstractEventDispatcher::aboutToBlock, this,
+                    [this]() { finishSample(); });
+        }
+    }
+
+    // Replays the file given by QWK_REPLAY_EVENTS once the window is shown,
+    // then writes the report as JSON to QWK_REPLAY_REPORT ("-" or unset for
+    // stdout) and quits
+    static void startFromEnvironment(QWidget *host) {
+        const QString path = qEnvironmentVariable("QWK_REPLAY_EVENTS");
+        if (path.isEmpty())
+            return;
+        const qreal speed =
+            qEnvironmentVariable("QWK_REPLAY_SPEED") == QStringLiteral("max")
+                ? 0.0
+                : qEnvironmentVariable("QWK_REPLAY_SPEED", QStringLiteral("1")).toDouble();
+        auto replayer = new EventReplayer(host, speed, [](const Report &report) {
+            writeReport(report, qEnvironmentVariable("QWK_REPLAY_REPORT"));
+            QCoreApplication::exit(0);
+        });
+        // Started from the event loop, exit() has no effect before exec()
+        QTimer::singleShot(0, replayer, [replayer, path]() {
+            if (!replayer->load(path)) {
+                QCoreApplication::exit(1);
+                return;
+            }
+            replayer->start();
+        });
+    }
+
+    bool load(const QString &path) {
+        QFile file(path);
+        if (!file.open(QIODevice::ReadOnly)) {
+            qWarning("EventReplayer: cannot read %s", qPrintable(path));
+            return false;
+        }
+        m_data = file.readAll();
+        return true;
+    }
+
+    void start() {
+        m_stream.reset(new QDataStream(m_data));
+        EventRecording::prepare(*m_stream);
+
+        quint32 magic = 0;
+        quint8 version = 0;
+        QSize size;
+        quint32 state = 0;
+        *m_stream >> magic >> version >> size >> state;
+        if (magic != EventRecording::Magic || version != EventRecording::Version) {
+            qWarning("EventReplayer: not an event recording");
+            finish();
+            return;
+        }
+
+        // Same starting point as the recorded session
+        m_host->setWindowState(Qt::WindowStates(int(state)));
+        if (!(m_host->windowState() & (Qt::WindowMaximized | Qt::WindowFullScreen))) {
+            m_host->resize(size);
+        }
+        m_clock.start();
+        scheduleNext();
+    }
+
+    static void writeReport(const Report &report, const QString &target) {
+        QJsonArray samples;
+        for (const Sample &sample : report.samples) {
+            samples.append(QJsonObject{
+                {QStringLiteral("type"), int(sample.type)},
+                {QStringLiteral("latency_ms"), sample.latencyNs / 1e6},
+            });
+        }
+        const QJsonObject result{
+            {QStringLiteral("version"), 1},
+            {QStringLiteral("platform"), QGuiApplication::platformName()},
+            {QStringLiteral("events"), report.events},
+            {QStringLiteral("skipped"), report.skipped},
+            {QStringLiteral("produced"), report.produced},
+            {QStringLiteral("total_ms"), report.totalNs / 1e6},
+            {QStringLiteral("p50_ms"), report.percentile(0.50) / 1e6},
+            {QStringLiteral("p95_ms"), report.percentile(0.95) / 1e6},
+            {QStringLiteral("max_ms"), report.percentile(1.0) / 1e6},
+            {QStringLiteral("samples"), samples},
+        };
+        const QByteArray json = QJsonDocument(result).toJson(QJsonDocument::Indented);
+
+        QFile out(target);
+        if (target.isEmpty() || target == QStringLiteral("-")
+                ? out.open(stdout, QIODevice::WriteOnly)
+                : out.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+            out.write(json);
+        } else {
+            qWarning("EventReplayer: cannot write %s", qPrintable(target));
+        }
+    }
+
+private:
+    struct Pending {
+        qint64 time{0};
+        quint16 type{0};
+        quint8 target{0};
+    };
+
+    void scheduleNext() {
+        if (!m_host || m_stream->atEnd()) {
+            finishSample();
+            finish();
+            return;
+        }
+        *m_stream >> m_next.time >> m_next.type >> m_next.target;
+
+        qint64 delayNs = 0;
+        if (m_speed > 0) {
+            delayNs = qint64(m_next.time / m_speed) - m_clock.nsecsElapsed();
+        }
+        m_timer.start(int(qMax<qint64>(0, delayNs / 1000000)));
+    }
+
+    void dispatchNext() {
+        finishSample();
+
+        const auto type = QEvent::Type(m_next.type);
+        const auto target = EventRecording::Target(m_next.target);
+        QDataStream &in = *m_stream;
+        m_sampleType = type;
+        m_sampleStart = m_clock.nsecsElapsed();
+
+        QWindow *window = EventRecording::targetWindow(m_host, target);
+        bool produced = false;
+        switch (type) {
+            case QEvent::Resize: {
+                QSize size;
+                in >> size;
+                if (m_host->size() == size) {
+                    produced = true;
+                } else {
+                    m_host->resize(size);
+                }
+                break;
+            }
+            case QEvent::Move: {
+                QPoint pos;
+                in >> pos;
+                if (m_host->pos() == pos) {
+                    produced = true;
+                } else {
+                    m_host->move(pos);
+                }
+                break;
+            }
+            case QEvent::WindowStateChange: {
+                quint32 state;
+                in >> state;
+                if (m_host->windowState() == Qt::WindowStates(int(state))) {
+                    produced = true;
+                } else {
+                    m_host->setWindowState(Qt::WindowStates(int(state)));
+                }
+                break;
+            }
+            case QEvent::MouseButtonPress:
+            case QEvent::MouseButtonRelease:
+            case QEvent::MouseButtonDblClick:
+            case QEvent::MouseMove: {
+                QPointF pos;
+                quint32 button, buttons, modifiers;
+                in >> pos >> button >> buttons >> modifiers;
+                if (window) {
+                    QMouseEvent e(type, pos, pos, window->mapToGlobal(pos.toPoint()),
+                                  Qt::MouseButton(button), Qt::MouseButtons(int(buttons)),
+                                  Qt::KeyboardModifiers(int(modifiers)));
+                    QCoreApplication::sendEvent(window, &e);
+                }
+                break;
+            }
+            case QEvent::Wheel: {
+                QPointF pos;
+                QPoint pixelDelta, angleDelta;
+                quint32 buttons, modifiers, phase;
+                bool inverted;
+                in >> pos >> pixelDelta >> angleDelta >> buttons >> modifiers >> phase >> inverted;
+                if (window) {
+                    QWheelEvent e(pos, window->mapToGlobal(pos.toPoint()), pixelDelta, angleDelta,
+                                  Qt::MouseButtons(int(buttons)), Qt::KeyboardModifiers(int(modifiers)),
+                                  Qt::ScrollPhase(phase), inverted);
+                    QCoreApplication::sendEvent(window, &e);
+                }
+                break;
+            }
+            case QEvent::KeyPress:
+            case QEvent::KeyRelease: {
+                qint32 key;
+                quint32 modifiers;
+                QString text;
+                bool autoRepeat;
+                in >> key >> modifiers >> text >> autoRepeat;
+                if (window) {
+                    QKeyEvent e(type, key, Qt::KeyboardModifiers(int(modifiers)), text, autoRepeat);
+                    QCoreApplication::sendEvent(window, &e);
+                }
+                break;
+            }
+            case QEvent::Enter: {
+                QPointF pos;
+                in >> pos;
+                if (window) {
+                    QEnterEvent e(pos, pos, window->mapToGlobal(pos.toPoint()));
+                    QCoreApplication::sendEvent(window, &e);
+                }
+                break;
+            }
+            case QEvent::Leave: {
+                if (window) {
+                    QEvent e(QEvent::Leave);
+                    QCoreApplication::sendEvent(window, &e);
+                }
+                break;
+            }
+            default:
+                qWarning("EventReplayer: unexpected event %d, stopping", int(type));
+                finish();
+                return;
+        }
+
+        ++m_report.events;
+        if (!window && m_next.target == EventRecording::Popup) {
+            ++m_report.skipped;
+            m_sampleStart = -1;
+        } else if (produced) {
+            ++m_report.produced;
+            m_sampleStart = -1;
+        }
+        scheduleNext();
+    }
+
+    // Closes the measurement of the last dispatched event
+    void finishSample() {
+        if (m_sampleStart < 0)
+            return;
+        m_report.samples.append({m_sampleType, m_clock.nsecsElapsed() - m_sampleStart});
+        m_sampleStart = -1;
+    }
+
+    void finish() {
+        if (m_finished)
+            return;
+        m_finished = true;
+        m_timer.stop();
+        m_report.totalNs = m_clock.isValid() ? m_clock.nsecsElapsed() : 0;
+        if (m_onFinished) {
+            m_onFinished(m_report);
+        }
+        deleteLater();
+    }
+
+    QPointer<QWidget> m_host;
+    qreal m_speed;
+    std::function<void(const Report &)> m_onFinished;
+    QByteArray m_data;
+    QScopedPointer<QDataStream> m_stream;
+    QTimer m_timer;
+    QElapsedTimer m_clock;
+    Pending m_next;
+    QEvent::Type m_sampleType{QEvent::None};
+    qint64 m_sampleStart{-1};
+    Report m_report;
+    bool m_finished{false};
+};
+
+#endif // EVENTRECORDER_H
@@ -0,0 +1,167 @@
+#ifndef FRAMELESSDIALOGPOOL_H
+#define FRAMELESSDIALOGPOOL_H
+
+#include <QObject>
+#include <QPointer>
+#include <QTimer>
+#include <QVector>
+#include <QLayout>
+
+#include "FramelessDialog.h"
+
+// Keeps a few FramelessDialogs built ahead of time.
+//
+// The dialogs are constructed one per event loop iteration once the parent
+// window has put its first frame on screen, so they never compete with the
+// startup of the window, and the window agent setup, WindowBar, system
+// buttons, qss and layout are already done when a dialog is needed. Each
+// construction is a "dialog-warmup" phase of the StartupProfiler. Callers acquire() a
+// dialog, fill it through setCentralWidget() and release() it afterwards;
+// the content is deleted and the dialog goes back to the pool. open() shows
+// an acquired dialog without blocking and releases it once it is finished.
+// The pool is refilled after the acquired dialog has painted its first
+// frame, so the refill never delays the dialog being opened.
+class FramelessDialogPool : public QObject {
+    Q_OBJECT
+public:
+    explicit FramelessDialogPool(QWidget *parent, int capacity = 1)
+        : QObject(parent), m_parent(parent), m_capacity(capacity)
+    {
+        if (parent->window()->isVisible()) {
+            m_ready = true;
+            QTimer::singleShot(0, this, &FramelessDialogPool::warmUp);
+        } else {
+            // The first frame is painted on expose, which does not always
+            // go through an UpdateRequest, but always paints the top-level
+            parent->window()->installEventFilter(this);
+        }
+    }
+
+    int capacity() const
+    {
+        return m_capacity;
+    }
+
+    void setCapacity(int capacity)
+    {
+        m_capacity = capacity;
+        while (m_idle.size() > m_capacity) {
+            if (auto dialog = m_idle.takeLast()) {
+                dialog->deleteLater();
+            }
+        }
+        QTimer::singleShot(0, this, &FramelessDialogPool::warmUp);
+    }
+
+    // Dialogs ready to be acquired without building one
+    int available() const
+    {
+        int count = 0;
+        for (const auto &dialog : m_idle) {
+            if (dialog) {
+                ++count;
+            }
+        }
+        return count;
+    }
+
+    // Returns a ready dialog, or builds one if the pool is empty
+    FramelessDialog *acquire()
+    {
+        FramelessDialog *dialog = nullptr;
+        while (!dialog && !m_idle.isEmpty()) {
+            dialog = m_idle.takeLast();
+        }
+        if (!dialog) {
+            dialog = createDialog();
+        }
+        // Refilled from its first paint
+        dialog->installEventFilter(this);
+        return dialog;
+    }
+
+    // Non-blocking replacement for exec() followed by release(). onFinished
+    // gets the result before the dialog content is deleted.
+    void open(FramelessDialog *dialog, std::function<void(int result)> onFinished = {})
+    {
+        QPointer<FramelessDialog> guard(dialog);
+        dialog->openAsync([this, guard, onFinished](int result) {
+            if (onFinished) {
+                onFinished(result);
+            }
+            release(guard);
+        });
+    }
+
+    void release(FramelessDialog *dialog)
+    {
+        if (!dialog)
+            return;
+
+        dialog->hide();
+        // Released before it was ever painted
+        dialog->removeEventFilter(this);
+        QTimer::singleShot(0, this, &FramelessDialogPool::warmUp);
+        if (auto content = dialog->takeCentralWidget()) {
+            content->deleteLater();
+        }
+        if (m_idle.size() >= m_capacity) {
+            dialog->deleteLater();
+            return;
+        }
+        m_idle.append(dialog);
+    }
+
+protected:
+    bool eventFilter(QObject *obj, QEvent *event) override
+    {
+        // The first frame of the parent window or of an acquired dialog
+        if (event->type() == QEvent::Paint) {
+            m_ready = true;
+            obj->removeEventFilter(this);
+            // Runs once the frame has been flushed
+            QTimer::singleShot(0, this, &FramelessDialogPool::warmUp);
+        }
+        return QObject::eventFilter(obj, event);
+    }
+
+private:
+    FramelessDialog *createDialog()
+    {
+        auto dialog = new FramelessDialog(m_parent, ThemeRegistry::instance()->theme());
+        dialog->ensurePolished();
+        if (auto layout = dialog->layout()) {
+            layout->activate();
+        }
+        return dialog;
+    }
+
+    // Builds one dialog at a time so that warming up never blocks the event loop
+    void warmUp()
+    {
+        if (!m_ready)
+            return;
+        for (int i = m_idle.size() - 1; i >= 0; --i) {
+            if (!m_idle.at(i)) {
+                m_idle.removeAt(i);
+            }
+        }
+        if (m_idle.size() >= m_capacity)
+            return;
+
+        {
+            StartupPhase phase("dialog-warmup");
+            m_idle.append(createDialog());
+        }
+        if (m_idle.size() < m_capacity) {
+            QTimer::singleShot(0, this, &FramelessDialogPool::warmUp);
+        }
+    }
+
+    QWidget *m_parent{nullptr};
+    int m_capacity{1};
+    bool m_ready{false};
+    QVector<QPointer<FramelessDialog>> m_idle;
+};
+
+#endif // FRAMELESSDIALOGPOOL_H
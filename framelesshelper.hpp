@@ -13,93 +13,172 @@
 #include <QActionGroup>
 #include <QStyle>
 #include <QFile>
+#include <QElapsedTimer>
+#include <algorithm>
+#include <memory>
+
+#include "themeengine.hpp"
+#include "themeregistry.hpp"
+#include "startupprofiler.hpp"
+#include "tracer.hpp"
+#include "hoverreconciler.hpp"
+#include "hittestmap.hpp"
+#include "screenchangecoalescer.hpp"
+#include "titleupdater.hpp"
+#include "framelesswindowmanager.hpp"
+#include "memoryreport.hpp"
+#include "paintdebugger.hpp"
+#include "stallwatchdog.hpp"
+#include "eventrecorder.hpp"
+#include "windowattributesink.hpp"
 
 namespace QWK {
     class WidgetWindowAgent;
     class StyleAgent;
 }
 
-static inline void emulateLeaveEvent(QWidget *widget) {
-    Q_ASSERT(widget);
-    if (!widget) {
-        return;
-    }
-    QTimer::singleShot(0, widget, [widget]() {
-#if (QT_VERSION >= QT_VERSION_CHECK(5, 14, 0))
-        const QScreen *screen = widget->screen();
-#else
-        const QScreen *screen = widget->windowHandle()->screen();
-#endif
-        const QPoint globalPos = QCursor::pos(screen);
-        if (!QRect(widget->mapToGlobal(QPoint{0, 0}), widget->size()).contains(globalPos)) {
-            QCoreApplication::postEvent(widget, new QEvent(QEvent::Leave));
-            if (widget->testAttribute(Qt::WA_Hover)) {
-                const QPoint localPos = widget->mapFromGlobal(globalPos);
-                const QPoint scenePos = widget->window()->mapFromGlobal(globalPos);
-                static constexpr const auto oldPos = QPoint{};
-                const Qt::KeyboardModifiers modifiers = QGuiApplication::keyboardModifiers();
-#if (QT_VERSION >= QT_VERSION_CHECK(6, 4, 0))
-                const auto event =
-                    new QHoverEvent(QEvent::HoverLeave, scenePos, globalPos, oldPos, modifiers);
-                Q_UNUSED(localPos);
-#elif (QT_VERSION >= QT_VERSION_CHECK(6, 3, 0))
-                const auto event =  new QHoverEvent(QEvent::HoverLeave, localPos, globalPos, oldPos, modifiers);
-                Q_UNUSED(scenePos);
-#else
-                const auto event =  new QHoverEvent(QEvent::HoverLeave, localPos, oldPos, modifiers);
-                Q_UNUSED(scenePos);
-#endif
-                QCoreApplication::postEvent(widget, event);
-            }
-        }
-    });
-}
-
-enum Theme {
-    Dark,
-    Light,
-};
-
 class FramelessHelper : public QObject {
     Q_OBJECT;
 public:
-    FramelessHelper(QWidget* parent, Theme theme):QObject(parent),m_target(parent),m_currentTheme(theme)
+    FramelessHelper(QWidget* parent, Theme theme, ThemeMode mode = ThemeMode::StyleSheet)
+        :QObject(parent),m_target(parent),m_currentTheme(theme),m_themeMode(mode)
     {
+        TraceScope trace("FramelessHelper", "helper");
         parent->setAttribute(Qt::WA_DontCreateNativeAncestors);
 
-        installWindowAgent();
+        const qint64 heapBefore = heapAccountingEnabled() ? currentHeapBytes() : -1;
+        {
+            StartupPhase phase("helper");
+            installWindowAgent();
+        }
+        {
+            StartupPhase phase("stylesheet");
+            loadStyleSheet(theme);
+        }
+        addHeapUsage(heapBefore);
 
-        loadStyleSheet(theme);
+        connect(ThemeRegistry::instance(), &ThemeRegistry::themeChanged, this,
+                &FramelessHelper::loadStyleSheet);
+    }
+
+    ~FramelessHelper() override
+    {
+        FramelessWindowManager::instance()->unregisterWindow(this);
     }
 
     void setMenuBar(QMenuBar* menuBar)
     {
         menuBar->setObjectName(QStringLiteral("win-menu-bar"));
         m_windowBar->setMenuBar(menuBar);
-        m_windowAgent->setHitTestVisible(menuBar, true);
+        setHitTestVisible(menuBar, true);
+
+        if (m_themeMode == ThemeMode::Native && m_themeApplied) {
+            applyNativeStyle(ThemePalette::forTheme(m_currentTheme));
+        }
 
     }
 
+    // For menus of the title bar created after setMenuBar(), such as lazily
+    // built submenus
+    void polishMenu(QMenu *menu)
+    {
+        if (m_themeMode != ThemeMode::Native || !m_themeApplied || !m_nativeStyle)
+            return;
+        if (menu->style() != m_nativeStyle) {
+            menu->setStyle(m_nativeStyle);
+        }
+        menu->setPalette(ThemePalette::forTheme(m_currentTheme).menuPalette(menu->palette()));
+    }
+
     void installWindowAgent() {
+        TraceScope trace("installWindowAgent", "helper");
         // 1. Setup window agent
         m_windowAgent = new QWK::WidgetWindowAgent(m_target);
         m_windowAgent->setup(m_target);
+        m_attributeSink = std::make_unique<AgentAttributeSink>(m_windowAgent);
 
 
         // menuBar->setObjectName(QStringLiteral("win-menu-bar"));
 
-        auto titleLabel = new QLabel();
+#ifndef Q_OS_MAC
+        m_windowBar = new QWK::WindowBar();
+        // The bar fills every pixel it is asked to repaint (titleBarEvent), so
+        // hover and state changes of its children stop at the bar instead of
+        // repainting the window beneath it
+        m_windowBar->setAttribute(Qt::WA_OpaquePaintEvent);
+#endif
+        // windowBar->setMenuBar(menuBar);
+        m_windowBar->setHostWidget(m_target);
+        // QLabel::setText() relayouts the bar, hostEvent() sets the title instead
+        m_windowBar->setTitleFollowWindow(false);
+
+        m_windowAgent->setTitleBar(m_windowBar);
+        m_hitTestMap = new HitTestMap(m_target, m_windowBar, m_windowAgent);
+
+        // windowAgent->setHitTestVisible(menuBar, true);
+
+#ifdef Q_OS_MAC
+        windowAgent->setSystemButtonAreaCallback([](const QSize &size) {
+            static constexpr const int width = 75;
+            return QRect(QPoint(size.width() - width, 0), QSize(width, size.height())); //
+        });
+#endif
+
+        // setMenuWidget(windowBar);
+
+#ifndef Q_OS_MAC
+        QObject::connect(m_windowBar, &QWK::WindowBar::minimizeRequested, m_target, &QWidget::showMinimized);
+        QObject::connect(m_windowBar, &QWK::WindowBar::maximizeRequested, m_target, [this](bool max) {
+            if (max)
+            {
+                m_target->showMaximized();
+            }
+            else
+            {
+                m_target->showNormal();
+            }
+        });
+        QObject::connect(m_windowBar, &QWK::WindowBar::closeRequested, m_target, &QWidget::close);
+
+        // Clears the hover state the title bar buttons keep after the window
+        // was maximized, restored or moved under a still cursor
+        m_hoverReconciler = new HoverReconciler(m_target, m_windowBar);
+#endif
+        // One relayout and repaint of the bar per monitor crossing
+        m_screenChangeCoalescer = new ScreenChangeCoalescer(m_target, m_windowBar, [this]() {
+            if (m_hoverReconciler)
+                m_hoverReconciler->schedule();
+            m_hitTestMap->invalidate();
+            m_windowBar->update();
+        });
+        m_titleUpdater = new TitleUpdater(m_target);
+        FramelessWindowManager::instance()->registerWindow(this, m_target, m_windowBar);
+
+        if (PaintDebugger::isEnabled()) {
+            m_paintDebugger = new PaintDebugger(m_target);
+        }
+    }
+
+    // The title label and the buttons are built when the host is first
+    // polished (right before it is shown) or when one of them is requested,
+    // whichever comes first. Windows that are never shown never pay for them.
+    void ensureTitleBarParts()
+    {
+        if (m_partsCreated)
+            return;
+        m_partsCreated = true;
+        const qint64 heapBefore = heapAccountingEnabled() ? currentHeapBytes() : -1;
+
+        auto titleLabel = new TitleLabel();
         titleLabel->setAlignment(Qt::AlignCenter);
         titleLabel->setObjectName(QStringLiteral("win-title-label"));
 
 #ifndef Q_OS_MAC
-        m_windowBar = new QWK::WindowBar();
-
         auto iconButton = new QWK::WindowButton();
         iconButton->setObjectName(QStringLiteral("icon-button"));
         iconButton->setSizePolicy(QSizePolicy::Preferred, QSizePolicy::Preferred);
         m_windowBar->setIconButton(iconButton);
-        m_windowAgent->setSystemButton(QWK::WindowAgentBase::WindowIcon, iconButton);
+        setSystemButton(QWK::WindowAgentBase::WindowIcon, iconButton);
 
         auto flags = m_target->windowFlags();
         if (flags.testFlag(Qt::WindowMinimizeButtonHint))
@@ -109,7 +188,7 @@ public:
             minButton->setProperty("system-button", true);
             minButton->setSizePolicy(QSizePolicy::Preferred, QSizePolicy::Preferred);
             m_windowBar->setMinButton(minButton);
-            m_windowAgent->setSystemButton(QWK::WindowAgentBase::Minimize, minButton);
+            setSystemButton(QWK::WindowAgentBase::Minimize, minButton);
         }
 
         if (flags.testFlag(Qt::WindowMaximizeButtonHint))
@@ -119,8 +198,9 @@ public:
             maxButton->setObjectName(QStringLiteral("max-button"));
             maxButton->setProperty("system-button", true);
             maxButton->setSizePolicy(QSizePolicy::Preferred, QSizePolicy::Preferred);
+            maxButton->setChecked(m_target->isMaximized());
             m_windowBar->setMaxButton(maxButton);
-            m_windowAgent->setSystemButton(QWK::WindowAgentBase::Maximize, maxButton);
+            setSystemButton(QWK::WindowAgentBase::Maximize, maxButton);
         }
 
         if (flags.testFlag(Qt::WindowCloseButtonHint))
@@ -130,58 +210,255 @@ public:
             closeButton->setProperty("system-button", true);
             closeButton->setSizePolicy(QSizePolicy::Preferred, QSizePolicy::Preferred);
             m_windowBar->setCloseButton(closeButton);
-            m_windowAgent->setSystemButton(QWK::WindowAgentBase::Close, closeButton);
+            setSystemButton(QWK::WindowAgentBase::Close, closeButton);
         }
 #endif
-        // windowBar->setMenuBar(menuBar);
         m_windowBar->setTitleLabel(titleLabel);
-        m_windowBar->setHostWidget(m_target);
-
-        m_windowAgent->setTitleBar(m_windowBar);
+        titleLabel->setTitle(m_target->windowTitle());
+        m_titleLabel = titleLabel;
+
+        if (m_themeMode == ThemeMode::Native && m_themeApplied) {
+            applyNativeStyle(ThemePalette::forTheme(m_currentTheme));
+        } else {
+            // Let the qss assign its properties first, then share the icons
+            for (auto button : m_windowBar->findChildren<QWK::WindowButton *>()) {
+                button->ensurePolished();
+            }
+            applyCachedIcons();
+        }
+        addHeapUsage(heapBefore);
+    }
 
-        // windowAgent->setHitTestVisible(menuBar, true);
+    QLabel *titleLabel()
+    {
+        ensureTitleBarParts();
+        return m_windowBar->titleLabel();
+    }
 
-#ifdef Q_OS_MAC
-        windowAgent->setSystemButtonAreaCallback([](const QSize &size) {
-            static constexpr const int width = 75;
-            return QRect(QPoint(size.width() - width, 0), QSize(width, size.height())); //
-        });
-#endif
+    QWidget *systemButton(QWK::WindowAgentBase::SystemButton button)
+    {
+        ensureTitleBarParts();
+        return m_windowAgent->systemButton(button);
+    }
 
-        // setMenuWidget(windowBar);
+    // Titles set through setTitle() are shown at most once per interval, the
+    // ones in between are dropped. 0 (the default) shows every title right
+    // away. Every window title only repaints the title label.
+    void setTitleUpdateInterval(int ms)
+    {
+        m_titleUpdater->setInterval(ms);
+    }
 
-#ifndef Q_OS_MAC
-        QObject::connect(m_windowBar, &QWK::WindowBar::minimizeRequested, m_target, &QWidget::showMinimized);
-        QObject::connect(m_windowBar, &QWK::WindowBar::maximizeRequested, m_target, [this](bool max) {
-            if (max)
-            {
-                m_target->showMaximized();
-            }
-            else
-            {
-                m_target->showNormal();
-            }
+    void setTitle(const QString &title)
+    {
+        m_titleUpdater->setTitle(title);
+    }
 
-                   // It's a Qt issue that if a QAbstractButton::clicked triggers a window's maximization,
-                   // the button remains to be hovered until the mouse move. As a result, we need to
-                   // manually send leave events to the button.
+    TitleUpdater::Stats titleUpdateStats() const
+    {
+        return m_titleUpdater->stats();
+    }
 
-            QTimer::singleShot(0, [btn = m_windowBar->maxButton()] { emulateLeaveEvent(btn); });
-        });
-        QObject::connect(m_windowBar, &QWK::WindowBar::closeRequested, m_target, &QWidget::close);
-#endif
+    FramelessMemoryReport memoryReport() const
+    {
+        return FramelessMemoryReport::collect(m_target, m_heapBytes);
     }
 
     void loadStyleSheet(Theme theme) {
-        if (!m_target->styleSheet().isEmpty() && theme == m_currentTheme)
+        if (m_themeApplied && theme == m_currentTheme)
             return;
+        TraceScope trace("loadStyleSheet", "theme");
         m_currentTheme = theme;
 
-        if (QFile qss(theme == Dark ? QStringLiteral(":/qss/dark-style.qss")
-                                    : QStringLiteral(":/qss/light-style.qss"));
-            qss.open(QIODevice::ReadOnly | QIODevice::Text)) {
-            m_target->setStyleSheet(QString::fromUtf8(qss.readAll()));
+        if (m_themeMode == ThemeMode::Native) {
+            applyNativeTheme(theme);
+            m_themeApplied = true;
             Q_EMIT themeChanged(m_currentTheme);
+            return;
+        }
+
+        QElapsedTimer timer;
+        timer.start();
+        int repolished = 0;
+
+        ThemeRegistry *registry = ThemeRegistry::instance();
+        QString sheet;
+        if (m_themeMode == ThemeMode::IncrementalStyleSheet) {
+            sheet = registry->incrementalStyleSheet();
+            if (!sheet.isEmpty()) {
+                m_target->setProperty(ThemeRegistry::themeProperty, ThemeRegistry::themeName(theme));
+                if (m_themeApplied) {
+                    repolished = repolishThemeDependents();
+                    sheet.clear();
+                }
+            } else {
+                // One of the themes is missing, replace the sheet as usual
+                sheet = registry->styleSheet(theme);
+                if (sheet.isEmpty())
+                    return;
+            }
+        } else {
+            sheet = registry->styleSheet(theme);
+            if (sheet.isEmpty())
+                return;
+        }
+
+        if (!sheet.isEmpty()) {
+            // Qt repolishes the whole subtree
+            m_target->setStyleSheet(sheet);
+            repolished = m_target->findChildren<QWidget *>().size() + 1;
+        }
+        applyCachedIcons();
+        m_themeApplied = true;
+        m_lastThemeSwitch = {repolished, timer.nsecsElapsed()};
+        Q_EMIT themeChanged(m_currentTheme);
+    }
+
+    // Recorded repaints of the window, nullptr unless QWK_PAINT_DEBUG is set
+    PaintDebugger *paintDebugger() const
+    {
+        return m_paintDebugger;
+    }
+
+    // GUI thread stalls recorded so far, see StallWatchdog. Stalls are
+    // process-wide, the GUI thread is shared by all windows.
+    StallWatchdog::Stats stallStats() const
+    {
+        return StallWatchdog::instance()->stats();
+    }
+
+    // Starts recording the input and the window state changes of the window,
+    // see EventRecorder. Returns the running recording if there is one.
+    EventRecorder *recordEvents()
+    {
+        if (!m_eventRecorder) {
+            m_eventRecorder = new EventRecorder(m_target);
+        }
+        return m_eventRecorder;
+    }
+
+    // Ends the recording and writes it to path
+    bool stopRecordingEvents(const QString &path)
+    {
+        if (!m_eventRecorder)
+            return false;
+        const bool saved = m_eventRecorder->save(path);
+        delete m_eventRecorder;
+        return saved;
+    }
+
+    // Replays a recording into the window, speed 1.0 keeps the recorded
+    // timing and 0 runs as fast as possible. onFinished gets the latency of
+    // every replayed event.
+    bool replayEvents(const QString &path, qreal speed,
+                      std::function<void(const EventReplayer::Report &)> onFinished)
+    {
+        auto replayer = new EventReplayer(m_target, speed, std::move(onFinished));
+        if (!replayer->load(path)) {
+            delete replayer;
+            return false;
+        }
+        replayer->start();
+        return true;
+    }
+
+    // Screen and ratio changes and how many relayouts they were merged into
+    ScreenChangeCoalescer::Stats screenChangeStats() const
+    {
+        return m_screenChangeCoalescer->stats();
+    }
+
+    // Widgets repolished by the last theme change and the time it took
+    ThemeSwitchStats lastThemeSwitch() const
+    {
+        return m_lastThemeSwitch;
+    }
+
+    // Switch between the qss paths and the native palette + FramelessStyle
+    // engine. The current theme is re-applied in the new mode.
+    void setThemeMode(ThemeMode mode) {
+        if (m_themeMode == mode)
+            return;
+        m_themeMode = mode;
+        m_themeApplied = false;
+
+        if (mode == ThemeMode::Native) {
+            m_target->setStyleSheet(QString());
+        } else {
+            removeNativeTheme();
+        }
+        loadStyleSheet(m_currentTheme);
+    }
+
+    ThemeMode themeMode() const
+    {
+        return m_themeMode;
+    }
+
+    // Flip the title bar between its active and inactive look. Both states are
+    // precomputed in ThemePalette, so this is a repaint of the bar only and the
+    // qss rules of the WindowBar subtree are not re-resolved. Themes with the
+    // same color for both states are not repainted at all.
+    void setBarActive(bool active)
+    {
+        const QVariant current = m_windowBar->property("bar-active");
+        if (current.isValid() && current.toBool() == active)
+            return;
+        m_windowBar->setProperty("bar-active", active);
+
+        const ThemePalette &colors = ThemePalette::forTheme(m_currentTheme);
+        if (!current.isValid() || colors.barActive != colors.barInactive)
+            m_windowBar->update();
+    }
+
+    // Widgets of the title bar that take the mouse instead of dragging the
+    // window. The agent is given the fewest widgets covering the same area,
+    // see HitTestMap.
+    void setHitTestVisible(QWidget *widget, bool visible = true)
+    {
+        m_hitTestMap->setHitTestVisible(widget, visible);
+    }
+
+    HitTestMap::Result hitTest(const QPoint &pos)
+    {
+        return m_hitTestMap->hitTest(pos);
+    }
+
+    HitTestMap::Stats hitTestStats() const
+    {
+        return m_hitTestMap->stats();
+    }
+
+    // Events of the host window and the title bar, dispatched by the
+    // FramelessWindowManager
+    void hostEvent(QEvent *event)
+    {
+        if (event->type() == QEvent::Polish)
+            ensureTitleBarParts();
+        // A repaint of the label, without the relayout of QLabel::setText()
+        if (event->type() == QEvent::WindowTitleChange && m_titleLabel)
+            m_titleLabel->setTitle(m_target->windowTitle());
+        // The layout of the host runs between here and the host's event()
+        if (event->type() == QEvent::LayoutRequest)
+            Tracer::markLayoutStart();
+        m_screenChangeCoalescer->hostEvent(event);
+        if (m_hoverReconciler)
+            m_hoverReconciler->hostEvent(event);
+    }
+
+    void titleBarEvent(QEvent *event)
+    {
+        m_hitTestMap->titleBarEvent(event);
+        // Opaque background of the bar in every theme mode, limited to the
+        // region being repainted
+        if (event->type() == QEvent::Paint) {
+            const ThemePalette &colors = ThemePalette::forTheme(m_currentTheme);
+            const QColor color = m_windowBar->property("bar-active").toBool() ? colors.barActive
+                                                                              : colors.barInactive;
+            QPainter painter(m_windowBar);
+            for (const QRect &rect : static_cast<QPaintEvent *>(event)->region()) {
+                painter.fillRect(rect, color);
+            }
         }
     }
 
@@ -190,9 +467,59 @@ public:
         return m_windowBar;
     }
 
-    void setWindowAttribute(const QString &key, const QVariant &attribute)
+    // Window attributes and the properties the qss reacts to are applied in
+    // one update. Between beginWindowUpdate() and commitWindowUpdate() changes
+    // are only recorded, the last value per key wins. The commit passes an
+    // attribute to the native side unless the agent already accepted the same
+    // value, clearing ones first since effects like mica and acrylic must not
+    // overlap, and polishes the window once if a property changed. Outside of
+    // an update every call commits immediately.
+    //
+    // The commit returns false if the agent rejected one of the attributes;
+    // inside an outer update it returns true, the outer commit tells.
+    void beginWindowUpdate()
+    {
+        ++m_windowUpdateDepth;
+    }
+
+    bool commitWindowUpdate()
+    {
+        if (m_windowUpdateDepth == 0 || --m_windowUpdateDepth > 0)
+            return true;
+        return applyWindowUpdate();
+    }
+
+    bool setWindowAttribute(const QString &key, const QVariant &attribute)
+    {
+        setPending(m_pendingAttributes, key, attribute);
+        if (m_windowUpdateDepth == 0)
+            return applyWindowUpdate();
+        return true;
+    }
+
+    void setWindowProperty(const char *name, const QVariant &value)
+    {
+        setPending(m_pendingProperties, QByteArray(name), value);
+        if (m_windowUpdateDepth == 0)
+            applyWindowUpdate();
+    }
+
+    // Sends the window attributes somewhere else than the window agent
+    void setWindowAttributeSink(std::unique_ptr<WindowAttributeSink> sink)
+    {
+        m_attributeSink = std::move(sink);
+        m_windowAttributes.clear();
+    }
+
+    struct WindowUpdateStats {
+        int commits{0};
+        int nativeCalls{0};
+        int polishes{0};
+    };
+
+    WindowUpdateStats windowUpdateStats() const
     {
-        m_windowAgent->setWindowAttribute(key, attribute);
+        return m_windowUpdateStats;
     }
 
     Theme getTheme()
@@ -204,11 +531,192 @@ Q_SIGNALS:
     void themeChanged(Theme theme);
 
 private:
+    template <typename Key>
+    static void setPending(QVector<QPair<Key, QVariant>> &pending, const Key &key,
+                           const QVariant &value)
+    {
+        for (auto &entry : pending) {
+            if (entry.first == key) {
+                entry.second = value;
+                return;
+            }
+        }
+        pending.append({key, value});
+    }
+
+    static bool isClearing(const QVariant &value)
+    {
+        return value.userType() == QMetaType::Bool && !value.toBool();
+    }
+
+    bool applyWindowUpdate()
+    {
+        ++m_windowUpdateStats.commits;
+
+        bool accepted = true;
+        for (bool clearing : {true, false}) {
+            for (const auto &entry : std::as_const(m_pendingAttributes)) {
+                if (isClearing(entry.second) != clearing)
+                    continue;
+                const auto current = m_windowAttributes.constFind(entry.first);
+                if (current != m_windowAttributes.cend() && current.value() == entry.second)
+                    continue;
+                ++m_windowUpdateStats.nativeCalls;
+                if (m_attributeSink->setWindowAttribute(entry.first, entry.second)) {
+                    m_windowAttributes.insert(entry.first, entry.second);
+                } else {
+                    // Asked again next time
+                    m_windowAttributes.remove(entry.first);
+                    accepted = false;
+                }
+            }
+        }
+        m_pendingAttributes.clear();
+
+        bool propertyChanged = false;
+        for (const auto &entry : std::as_const(m_pendingProperties)) {
+            if (m_target->property(entry.first.constData()) != entry.second) {
+                m_target->setProperty(entry.first.constData(), entry.second);
+                propertyChanged = true;
+            }
+        }
+        m_pendingProperties.clear();
+
+        if (propertyChanged) {
+            m_target->style()->polish(m_target);
+            ++m_windowUpdateStats.polishes;
+        }
+        return accepted;
+    }
+
+    void addHeapUsage(qint64 heapBefore)
+    {
+        if (heapBefore < 0)
+            return;
+        const qint64 heapAfter = currentHeapBytes();
+        if (heapAfter < 0)
+            return;
+        m_heapBytes = qMax<qint64>(m_heapBytes, 0) + (heapAfter - heapBefore);
+    }
+
+    void setSystemButton(QWK::WindowAgentBase::SystemButton button, QWidget *widget)
+    {
+        m_hitTestMap->setSystemButton(button, widget);
+    }
+
+    // The qss assigns a fresh icon to every button on each polish; swap them
+    // for the shared, already rasterized ones before anything is painted.
+    void applyCachedIcons() {
+        for (auto button : m_windowBar->findChildren<QWK::WindowButton *>()) {
+            WindowBarIcons::apply(button);
+        }
+    }
+
+    // The sheet of the host holds both themes and stays as it is; only the
+    // widgets matched by rules that differ between the themes re-resolve
+    // their style. The cached rules of all other widgets remain valid.
+    int repolishThemeDependents() {
+        const QVector<ThemeSelector> dependents = ThemeRegistry::instance()->themeDependents();
+        QList<QWidget *> widgets = m_target->findChildren<QWidget *>();
+        widgets.prepend(m_target);
+
+        int count = 0;
+        for (QWidget *w : std::as_const(widgets)) {
+            const bool dependent = std::any_of(dependents.cbegin(), dependents.cend(),
+                                               [w](const ThemeSelector &selector) {
+                                                   return selector.matches(w);
+                                               });
+            if (!dependent)
+                continue;
+
+            QStyle *style = w->style();
+            style->unpolish(w);
+            style->polish(w);
+            QEvent styleChange(QEvent::StyleChange);
+            QCoreApplication::sendEvent(w, &styleChange);
+            w->update();
+            w->updateGeometry();
+            ++count;
+        }
+        return count;
+    }
+
+    void applyNativeTheme(Theme theme) {
+        m_nativeStyle = ThemeRegistry::instance()->nativeStyle();
+
+        const ThemePalette &colors = ThemePalette::forTheme(theme);
+        m_target->setPalette(colors.windowPalette(m_target->palette()));
+        applyNativeStyle(colors);
+    }
+
+    void applyNativeStyle(const ThemePalette &colors) {
+        QList<QWidget *> widgets = m_windowBar->findChildren<QWidget *>();
+        widgets.prepend(m_windowBar);
+        for (QWidget *w : std::as_const(widgets)) {
+            if (w->style() != m_nativeStyle) {
+                w->setStyle(m_nativeStyle);
+            }
+            if (qobject_cast<QMenu *>(w)) {
+                w->setPalette(colors.menuPalette(w->palette()));
+            }
+        }
+        m_windowBar->setPalette(colors.barPalette(m_windowBar->palette()));
+    }
+
+    void removeNativeTheme() {
+        if (!m_nativeStyle)
+            return;
+
+        QList<QWidget *> widgets = m_windowBar->findChildren<QWidget *>();
+        widgets.prepend(m_windowBar);
+        for (QWidget *w : std::as_const(widgets)) {
+            if (w->style() == m_nativeStyle) {
+                w->setStyle(nullptr);
+            }
+            if (qobject_cast<QMenu *>(w)) {
+                w->setPalette(QPalette());
+            }
+        }
+        m_windowBar->setPalette(QPalette());
+        m_target->setPalette(QPalette());
+    }
 
     QWidget *m_target{nullptr};
     Theme m_currentTheme{};
+    ThemeMode m_themeMode{ThemeMode::StyleSheet};
+    bool m_themeApplied{false};
+    FramelessStyle *m_nativeStyle{nullptr};
     QWK::WidgetWindowAgent *m_windowAgent;
     QWK::WindowBar* m_windowBar;
+    HoverReconciler *m_hoverReconciler{nullptr};
+    HitTestMap *m_hitTestMap{nullptr};
+    ScreenChangeCoalescer *m_screenChangeCoalescer{nullptr};
+    TitleUpdater *m_titleUpdater{nullptr};
+    TitleLabel *m_titleLabel{nullptr};
+    bool m_partsCreated{false};
+    ThemeSwitchStats m_lastThemeSwitch;
+    PaintDebugger *m_paintDebugger{nullptr};
+    QPointer<EventRecorder> m_eventRecorder;
+    int m_windowUpdateDepth{0};
+    QVector<QPair<QString, QVariant>> m_pendingAttributes;
+    QVector<QPair<QByteArray, QVariant>> m_pendingProperties;
+    std::unique_ptr<WindowAttributeSink> m_attributeSink;
+    // Values the sink accepted
+    QHash<QString, QVariant> m_windowAttributes;
+    WindowUpdateStats m_windowUpdateStats;
+    qint64 m_heapBytes{-1};
 };
 
+inline bool FramelessWindowManager::eventFilter(QObject *obj, QEvent *event) {
+    const auto it = m_windows.constFind(obj);
+    if (it != m_windows.constEnd()) {
+        if (it->role == Host) {
+            it->helper->hostEvent(event);
+        } else {
+            it->helper->titleBarEvent(event);
+        }
+    }
+    return QObject::eventFilter(obj, event);
+}
+
 #endif // FRAMELESSHELPER_H
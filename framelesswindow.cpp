@@ -8,11 +8,13 @@
 #include <QtCore/QFile>
 #include <QtCore/QTime>
 #include <QtCore/QTimer>
+#include <QtGui/QCloseEvent>
 #include <QtGui/QPainter>
 #include <QtGui/QWindow>
 #include <QtWidgets/QApplication>
 #include <QtWidgets/QStyle>
 #include <QtWidgets/QPushButton>
+#include <QtWidgets/QMessageBox>
 #if QT_VERSION >= QT_VERSION_CHECK(6, 0, 0)
 #  include <QtGui/QActionGroup>
 #else
@@ -22,184 +24,240 @@
 // #include <QtWebEngineWidgets/QWebEngineView>
 
 #include "FramelessDialog.h"
-
-class ClockWidget : public QLabel {
+#include "framelessdialogpool.hpp"
+#include "tickservice.hpp"
+#include "menumodel.hpp"
+#include "windowstate.hpp"
+#include "updatechannel.hpp"
+
+// Draws the time itself instead of going through QLabel::setText(), which
+// repaints the whole (expanding) contents rect and requests a relayout on
+// every change. A tick only repaints the glyphs of the old and new text.
+class ClockWidget : public QWidget {
 public:
-    explicit ClockWidget(QWidget *parent = nullptr) : QLabel(parent) {
-        startTimer(100);
-        setAlignment(Qt::AlignCenter);
+    explicit ClockWidget(QWidget *parent = nullptr) : QWidget(parent) {
+        // Used by the native theme engine, the qss rule overrides it otherwise
+        QFont f = font();
+        f.setPixelSize(75);
+        f.setBold(true);
+        setFont(f);
+
+        TickService::instance()->subscribe(this, [this](const QTime &time) {
+            const QString text = time.toString(QStringLiteral("hh:mm:ss"));
+            if (text != m_text) {
+                const QRect oldRect = textRect();
+                m_text = text;
+                update(oldRect | textRect());
+            }
+        });
     }
 
     ~ClockWidget() override = default;
 
+    QSize sizeHint() const override {
+        return fontMetrics().size(Qt::TextSingleLine, QStringLiteral("00:00:00"));
+    }
+
 protected:
-    void timerEvent(QTimerEvent *event) override {
-        QLabel::timerEvent(event);
-        setText(QTime::currentTime().toString(QStringLiteral("hh:mm:ss")));
+    void paintEvent(QPaintEvent *event) override {
+        Q_UNUSED(event);
+        QPainter painter(this);
+        painter.setPen(palette().color(QPalette::WindowText));
+        painter.drawText(rect(), Qt::AlignCenter, m_text);
+    }
+
+private:
+    // Glyphs can reach slightly past the logical text rect
+    QRect textRect() const {
+        return fontMetrics().boundingRect(rect(), Qt::AlignCenter, m_text).adjusted(-2, -2, 2, 2);
     }
+
+    QString m_text;
+};
+
+// The texts of menus/mainwindow.json, for lupdate. MenuModel translates them
+// in the FramelessWindow context. qmake checks that the list matches the JSON
+// (menus/menus.pri).
+Q_DECL_UNUSED static const char *const MenuTexts[] = {
+    QT_TRANSLATE_NOOP("FramelessWindow", "File(&F)"),
+    QT_TRANSLATE_NOOP("FramelessWindow", "New(&N)"),
+    QT_TRANSLATE_NOOP("FramelessWindow", "Open(&O)"),
+    QT_TRANSLATE_NOOP("FramelessWindow", "Edit(&E)"),
+    QT_TRANSLATE_NOOP("FramelessWindow", "Undo(&U)"),
+    QT_TRANSLATE_NOOP("FramelessWindow", "Redo(&R)"),
+    QT_TRANSLATE_NOOP("FramelessWindow", "Settings(&S)"),
+    QT_TRANSLATE_NOOP("FramelessWindow", "Enable dark theme"),
+    QT_TRANSLATE_NOOP("FramelessWindow", "Style sheet theme engine"),
+    QT_TRANSLATE_NOOP("FramelessWindow", "Incremental style sheet theme engine"),
+    QT_TRANSLATE_NOOP("FramelessWindow", "Native theme engine"),
+    QT_TRANSLATE_NOOP("FramelessWindow", "custom dialog"),
+    QT_TRANSLATE_NOOP("FramelessWindow", "Debug"),
+    QT_TRANSLATE_NOOP("FramelessWindow", "Detect GUI stalls"),
+    QT_TRANSLATE_NOOP("FramelessWindow", "Stall statistics..."),
+    QT_TRANSLATE_NOOP("FramelessWindow", "None"),
+    QT_TRANSLATE_NOOP("FramelessWindow", "Enable DWM blur"),
+    QT_TRANSLATE_NOOP("FramelessWindow", "Enable acrylic material"),
+    QT_TRANSLATE_NOOP("FramelessWindow", "Enable mica"),
+    QT_TRANSLATE_NOOP("FramelessWindow", "Enable mica alt"),
+    QT_TRANSLATE_NOOP("FramelessWindow", "Dark blur"),
+    QT_TRANSLATE_NOOP("FramelessWindow", "Light blur"),
+    QT_TRANSLATE_NOOP("FramelessWindow", "No blur"),
 };
 
-FramelessWindow::FramelessWindow(QWidget *parent) : QMainWindow(parent) {
+FramelessWindow::FramelessWindow(QWidget *parent, const QString &stateId)
+    : QMainWindow(parent), m_stateId(stateId) {
 
-    m_helper = new FramelessHelper(this, Theme::Dark);
+    // The theme goes straight into the helper, so the sheet is loaded once
+    WindowState state = WindowState::load(m_stateId);
+    const Theme theme = ThemeRegistry::instance()->restoreTheme(state.theme);
+    m_helper = new FramelessHelper(this, theme, state.themeMode);
+    m_dialogPool = new FramelessDialogPool(this);
+    m_updateChannel = new UpdateChannel(this);
+    m_updateChannel->bind(QStringLiteral("title"), [this](const QVariant &title) {
+        m_helper->setTitle(title.toString());
+    });
 
     // 2. Construct your title bar
     auto menuBar = [this]() {
+        StartupPhase phase("menu");
         auto menuBar = new QMenuBar(this);
 
-        // Virtual menu
-        auto file = new QMenu(tr("File(&F)"), menuBar);
-        file->addAction(new QAction(tr("New(&N)"), menuBar));
-        file->addAction(new QAction(tr("Open(&O)"), menuBar));
-        file->addSeparator();
-
-        auto edit = new QMenu(tr("Edit(&E)"), menuBar);
-        edit->addAction(new QAction(tr("Undo(&U)"), menuBar));
-        edit->addAction(new QAction(tr("Redo(&R)"), menuBar));
-
-        auto dlgAction = new QAction(tr("custom dialog"), menuBar);
-        connect(dlgAction, &QAction::triggered, this, [this]() {
-            auto label = new QLabel("Hello world");
-            label->setObjectName("test");
-            label->setAlignment(Qt::AlignCenter);
-            label->setSizePolicy(QSizePolicy::Expanding, QSizePolicy::Expanding);
-            FramelessDialog dialog(this, m_helper->getTheme());
-            dialog.setWindowTitle("Help");
-            dialog.setFixedSize(400, 240);
-            dialog.setCentralWidget(label);
-            dialog.exec();
+        // The menus are described in menus/mainwindow.json, their actions are
+        // created when a menu is opened for the first time
+        auto menuModel = new MenuModel(QStringLiteral(":/menus/mainwindow.json"), menuBar,
+                                       "FramelessWindow");
+        // Submenus are built when their parent opens, after setMenuBar() styled the bar
+        menuModel->bindMenus([this](QMenu *menu) { m_helper->polishMenu(menu); });
+
+        menuModel->bind(QStringLiteral("custom-dialog"), [this](QAction *action) {
+            connect(action, &QAction::triggered, this, [this]() {
+                auto label = new QLabel("Hello world");
+                label->setObjectName("test");
+                label->setAlignment(Qt::AlignCenter);
+                label->setSizePolicy(QSizePolicy::Expanding, QSizePolicy::Expanding);
+                auto dialog = m_dialogPool->acquire();
+                dialog->setThemeMode(m_helper->themeMode());
+                dialog->setWindowTitle("Help");
+                dialog->setFixedSize(400, 240);
+                dialog->setCentralWidget(label);
+                m_dialogPool->open(dialog);
+            });
+        });
+
+        // Debug
+        menuModel->bind(QStringLiteral("stall-watchdog"), [this](QAction *action) {
+            action->setChecked(StallWatchdog::instance()->isRunning());
+            connect(action, &QAction::toggled, this, [](bool checked) {
+                if (checked) {
+                    StallWatchdog::instance()->start(100);
+                } else {
+                    StallWatchdog::instance()->stop();
+                }
+            });
+        });
+        menuModel->bind(QStringLiteral("stall-statistics"), [this](QAction *action) {
+            connect(action, &QAction::triggered, this, [this]() {
+                const StallWatchdog::Stats stats = m_helper->stallStats();
+                QString text = tr("%1 stalls, %2 ms in total, longest %3 ms")
+                                   .arg(stats.stalls)
+                                   .arg(stats.totalNs / 1000000)
+                                   .arg(stats.maxNs / 1000000);
+                for (auto it = stats.recent.crbegin(); it != stats.recent.crend(); ++it) {
+                    text += QStringLiteral("\n%1 ms  %2  %3")
+                                .arg(it->durationNs / 1000000)
+                                .arg(it->event, it->receiver);
+                }
+                auto box = new QMessageBox(QMessageBox::Information, tr("Stall statistics"), text,
+                                           QMessageBox::Ok, this);
+                box->setAttribute(Qt::WA_DeleteOnClose);
+                box->open();
+            });
         });
 
         // Theme action
-        auto darkAction = new QAction(tr("Enable dark theme"), menuBar);
-        darkAction->setCheckable(true);
-        darkAction->setChecked(true);
-        connect(darkAction, &QAction::triggered, this, [this](bool checked) {
-            m_helper->loadStyleSheet(checked ? Dark : Light); //
+        menuModel->bind(QStringLiteral("dark-theme"), [this](QAction *darkAction) {
+            darkAction->setChecked(m_helper->getTheme() == Dark);
+            connect(darkAction, &QAction::triggered, this, [this](bool checked) {
+                ThemeRegistry::instance()->setTheme(checked ? Dark : Light); //
+            });
+            connect(m_helper, &FramelessHelper::themeChanged, darkAction, [darkAction](Theme theme) {
+                darkAction->setChecked(theme == Dark); //
+            });
         });
-        connect(m_helper, &FramelessHelper::themeChanged, darkAction, [this, darkAction](Theme theme) {
-            darkAction->setChecked(theme == Dark); //
+
+        // Theme engine
+        menuModel->bindGroup(QStringLiteral("theme-engine"), [this](QActionGroup *themeModeGroup) {
+            for (QAction *action : themeModeGroup->actions()) {
+                action->setChecked(ThemeMode(action->data().toInt()) == m_helper->themeMode());
+            }
+            connect(themeModeGroup, &QActionGroup::triggered, this, [this](QAction *action) {
+                m_helper->setThemeMode(ThemeMode(action->data().toInt())); //
+            });
         });
 
 #ifdef Q_OS_WIN
-        auto noneAction = new QAction(tr("None"), menuBar);
-        noneAction->setData(QStringLiteral("none"));
-        noneAction->setCheckable(true);
-        noneAction->setChecked(true);
-
-        auto dwmBlurAction = new QAction(tr("Enable DWM blur"), menuBar);
-        dwmBlurAction->setData(QStringLiteral("dwm-blur"));
-        dwmBlurAction->setCheckable(true);
-
-        auto acrylicAction = new QAction(tr("Enable acrylic material"), menuBar);
-        acrylicAction->setData(QStringLiteral("acrylic-material"));
-        acrylicAction->setCheckable(true);
-
-        auto micaAction = new QAction(tr("Enable mica"), menuBar);
-        micaAction->setData(QStringLiteral("mica"));
-        micaAction->setCheckable(true);
-
-        auto micaAltAction = new QAction(tr("Enable mica alt"), menuBar);
-        micaAltAction->setData(QStringLiteral("mica-alt"));
-        micaAltAction->setCheckable(true);
-
-        auto winStyleGroup = new QActionGroup(menuBar);
-        winStyleGroup->addAction(noneAction);
-        winStyleGroup->addAction(dwmBlurAction);
-        winStyleGroup->addAction(acrylicAction);
-        winStyleGroup->addAction(micaAction);
-        winStyleGroup->addAction(micaAltAction);
-        connect(winStyleGroup, &QActionGroup::triggered, this,
-                [this, winStyleGroup](QAction *action) {
-                    // Unset all custom style attributes first, otherwise the style will not display
-                    // correctly
-                    for (const QAction *_act : winStyleGroup->actions()) {
-                        const QString data = _act->data().toString();
-                        if (data.isEmpty() || data == QStringLiteral("none")) {
-                            continue;
+        menuModel->bindGroup(QStringLiteral("window-style"), [this](QActionGroup *winStyleGroup) {
+            checkWindowStyle(winStyleGroup);
+            connect(winStyleGroup, &QActionGroup::triggered, this,
+                    [this, winStyleGroup](QAction *action) {
+                        // One update: the helper only clears the style that is
+                        // actually set, then sets the new one and polishes once
+                        auto applyStyle = [this, winStyleGroup](const QString &style) {
+                            m_helper->beginWindowUpdate();
+                            for (const QAction *_act : winStyleGroup->actions()) {
+                                const QString data = _act->data().toString();
+                                if (data.isEmpty() || data == QStringLiteral("none")) {
+                                    continue;
+                                }
+                                m_helper->setWindowAttribute(data, false);
+                            }
+                            if (!style.isEmpty()) {
+                                m_helper->setWindowAttribute(style, true);
+                            }
+                            m_helper->setWindowProperty("custom-style", !style.isEmpty());
+                            return m_helper->commitWindowUpdate();
+                        };
+
+                        const QString data = action->data().toString();
+                        if (data.isEmpty())
+                            return;
+                        const QString style = data == QStringLiteral("none") ? QString() : data;
+                        if (applyStyle(style)) {
+                            m_windowStyle = style;
+                            return;
+                        }
+
+                        // Rejected: back to the previous style, or to none if that
+                        // is rejected as well, and check the action in effect
+                        if (m_windowStyle.isEmpty() || !applyStyle(m_windowStyle)) {
+                            applyStyle(QString());
+                            m_windowStyle.clear();
                         }
-                        m_helper->setWindowAttribute(data, false);
-                    }
-                    const QString data = action->data().toString();
-                    if (data == QStringLiteral("none")) {
-                        setProperty("custom-style", false);
-                    } else if (!data.isEmpty()) {
-                        m_helper->setWindowAttribute(data, true);
-                        setProperty("custom-style", true);
-                    }
-                    style()->polish(this);
-                });
+                        checkWindowStyle(winStyleGroup);
+                    });
+        });
 
 #elif defined(Q_OS_MAC)
         // Set whether to use system buttons (close/minimize/zoom)
         // - true:  Hide system buttons (use custom UI controls)
         // - false: Show native system buttons (default behavior)
-        windowAgent->setWindowAttribute(QStringLiteral("no-system-buttons"), false);
-
-        auto darkBlurAction = new QAction(tr("Dark blur"), menuBar);
-        darkBlurAction->setCheckable(true);
-        connect(darkBlurAction, &QAction::toggled, target_, [target_](bool checked) {
-            if (!windowAgent->setWindowAttribute(QStringLiteral("blur-effect"), "dark")) {
-                return;
-            }
-            if (checked) {
-                setProperty("custom-style", true);
-                style()->polish(target_);
-            }
-        });
-
-        auto lightBlurAction = new QAction(tr("Light blur"), menuBar);
-        lightBlurAction->setCheckable(true);
-        connect(lightBlurAction, &QAction::toggled, target_, [target_](bool checked) {
-            if (!windowAgent->setWindowAttribute(QStringLiteral("blur-effect"), "light")) {
-                return;
-            }
-            if (checked) {
-                setProperty("custom-style", true);
-                style()->polish(target_);
-            }
-        });
-
-        auto noBlurAction = new QAction(tr("No blur"), menuBar);
-        noBlurAction->setCheckable(true);
-        connect(noBlurAction, &QAction::toggled, target_, [target_](bool checked) {
-            if (!windowAgent->setWindowAttribute(QStringLiteral("blur-effect"), "none")) {
-                return;
-            }
-            if (checked) {
-                setProperty("custom-style", false);
-                style()->polish(target_);
-            }
+        m_helper->setWindowAttribute(QStringLiteral("no-system-buttons"), false);
+
+        menuModel->bindGroup(QStringLiteral("blur-effect"), [this](QActionGroup *macStyleGroup) {
+            checkWindowStyle(macStyleGroup);
+            connect(macStyleGroup, &QActionGroup::triggered, this,
+                    [this, macStyleGroup](QAction *action) {
+                        const QString data = action->data().toString();
+                        if (!m_helper->setWindowAttribute(QStringLiteral("blur-effect"), data)) {
+                            checkWindowStyle(macStyleGroup);
+                            return;
+                        }
+                        m_helper->setWindowProperty("custom-style", data != QStringLiteral("none"));
+                        m_windowStyle = data == QStringLiteral("none") ? QString() : data;
+                    });
         });
-
-        auto macStyleGroup = new QActionGroup(menuBar);
-        macStyleGroup->addAction(darkBlurAction);
-        macStyleGroup->addAction(lightBlurAction);
-        macStyleGroup->addAction(noBlurAction);
-#endif
-
-               // Real menu
-        auto settings = new QMenu(tr("Settings(&S)"), menuBar);
-        settings->addAction(darkAction);
-        settings->addAction(dlgAction);
-
-
-#ifdef Q_OS_WIN
-        settings->addSeparator();
-        settings->addAction(noneAction);
-        settings->addAction(dwmBlurAction);
-        settings->addAction(acrylicAction);
-        settings->addAction(micaAction);
-        settings->addAction(micaAltAction);
-#elif defined(Q_OS_MAC)
-        settings->addAction(darkBlurAction);
-        settings->addAction(lightBlurAction);
-        settings->addAction(noBlurAction);
 #endif
 
-        menuBar->addMenu(file);
-        menuBar->addMenu(edit);
-        menuBar->addMenu(settings);
         return menuBar;
     }();
 
@@ -220,7 +278,26 @@ FramelessWindow::FramelessWindow(QWidget *parent) : QMainWindow(parent) {
 
 
     setWindowTitle(tr("Example MainWindow"));
-    resize(800, 600);
+
+    // Geometry, maximized state and custom style are in place before the
+    // first show, which then polishes and lays out the window once
+    if (!state.windowStyle.isEmpty()) {
+#ifdef Q_OS_WIN
+        const bool restored = m_helper->setWindowAttribute(state.windowStyle, true);
+#elif defined(Q_OS_MAC)
+        const bool restored =
+            m_helper->setWindowAttribute(QStringLiteral("blur-effect"), state.windowStyle);
+#else
+        const bool restored = false;
+#endif
+        if (!restored) {
+            state.windowStyle.clear();
+        }
+    }
+    m_windowStyle = state.windowStyle;
+    if (!state.apply(this)) {
+        resize(800, 600);
+    }
 
     // setFixedHeight(600);
     // windowAgent->centralize();
@@ -228,23 +305,37 @@ FramelessWindow::FramelessWindow(QWidget *parent) : QMainWindow(parent) {
 
 FramelessWindow::~FramelessWindow() = default;
 
+FramelessMemoryReport FramelessWindow::memoryReport() const {
+    return m_helper->memoryReport();
+}
+
+UpdateChannel *FramelessWindow::updateChannel() const {
+    return m_updateChannel;
+}
+
+void FramelessWindow::closeEvent(QCloseEvent *event) {
+    WindowState::capture(this, m_helper->getTheme(), m_helper->themeMode(), m_windowStyle)
+        .save(m_stateId);
+    QMainWindow::closeEvent(event);
+}
+
+void FramelessWindow::checkWindowStyle(QActionGroup *group) const {
+    const QString current = m_windowStyle.isEmpty() ? QStringLiteral("none") : m_windowStyle;
+    for (QAction *action : group->actions()) {
+        action->setChecked(action->data().toString() == current);
+    }
+}
+
 bool FramelessWindow::event(QEvent *event) {
+    const TraceScope trace = TraceScope::forHostEvent(event);
     switch (event->type()) {
         case QEvent::WindowActivate: {
-            auto menu = menuWidget();
-            if (menu) {
-                menu->setProperty("bar-active", true);
-                style()->polish(menu);
-            }
+            m_helper->setBarActive(true);
             break;
         }
 
         case QEvent::WindowDeactivate: {
-            auto menu = menuWidget();
-            if (menu) {
-                menu->setProperty("bar-active", false);
-                style()->polish(menu);
-            }
+            m_helper->setBarActive(false);
             break;
         }
 
@@ -8,20 +8,37 @@
 #include <QtWidgets/QMainWindow>
 #include "framelesshelper.hpp"
 
+class FramelessDialogPool;
+class UpdateChannel;
+class QActionGroup;
 
 class FramelessWindow : public QMainWindow {
     Q_OBJECT
 public:
-    explicit FramelessWindow(QWidget *parent = nullptr);
+    // The window state is saved on close and restored under stateId
+    explicit FramelessWindow(QWidget *parent = nullptr,
+                             const QString &stateId = QStringLiteral("main"));
     ~FramelessWindow() override;
 
+    FramelessMemoryReport memoryReport() const;
+
+    // Updates posted by worker threads, delivered on the GUI thread once per
+    // frame with the latest value per key. "title" sets the window title.
+    UpdateChannel *updateChannel() const;
+
 
 protected:
     bool event(QEvent *event) override;
+    void closeEvent(QCloseEvent *event) override;
 
 private:
+    void checkWindowStyle(QActionGroup *group) const;
 
     FramelessHelper* m_helper;
+    FramelessDialogPool* m_dialogPool;
+    UpdateChannel* m_updateChannel;
+    QString m_stateId;
+    QString m_windowStyle;
 };
 
 #endif // FRAMELESSWINDOW_H
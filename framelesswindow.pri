@@ -0,0 +1,56 @@
+# 窗口、对话框与辅助类，由主程序、bench/ 与 tests/ 共用
+# 使用方需设置 QT += widgets 与 CONFIG += c++17
+
+# 头文件
+HEADERS += \
+    $$PWD/FramelessDialog.h \
+    $$PWD/eventrecorder.hpp \
+    $$PWD/framelessdialogpool.hpp \
+    $$PWD/framelesshelper.hpp \
+    $$PWD/framelesswindow.h \
+    $$PWD/framelesswindowmanager.hpp \
+    $$PWD/hittestmap.hpp \
+    $$PWD/hoverreconciler.hpp \
+    $$PWD/iconcache.hpp \
+    $$PWD/memoryreport.hpp \
+    $$PWD/menumodel.hpp \
+    $$PWD/paintdebugger.hpp \
+    $$PWD/screenchangecoalescer.hpp \
+    $$PWD/startuppreloader.hpp \
+    $$PWD/startupprofiler.hpp \
+    $$PWD/stallwatchdog.hpp \
+    $$PWD/themediff.hpp \
+    $$PWD/themeengine.hpp \
+    $$PWD/themeregistry.hpp \
+    $$PWD/tickservice.hpp \
+    $$PWD/titleupdater.hpp \
+    $$PWD/tracer.hpp \
+    $$PWD/updatechannel.hpp \
+    $$PWD/windowattributesink.hpp \
+    $$PWD/windowstate.hpp
+
+# 源文件
+SOURCES += \
+    $$PWD/FramelessDialog.cpp \
+    $$PWD/framelesswindow.cpp
+
+# 菜单资源与菜单文本检查
+include($$PWD/menus/menus.pri)
+
+# 包含路径
+INCLUDEPATH += $$PWD $$PWD/thirdparty/qwindowkit/include
+
+# QWKWidgets 库配置
+CONFIG(debug, debug|release) {
+    # Debug 版本
+    LIBS += -L$$PWD/thirdparty/qwindowkit/lib -lQWKWidgetsd -lWidgetFramed -lQWKCored
+} else {
+    # Release 版本
+    LIBS += -L$$PWD/thirdparty/qwindowkit/lib -lQWKWidgets -lWidgetFrame -lQWKCore
+}
+
+RESOURCES += \
+    $$PWD/shared/resources/shared.qrc
+
+# 主题编译（由 themes/theme.qss.in 生成 dark/light 样式表）
+include($$PWD/themes/themes.pri)
@@ -0,0 +1,80 @@
+#ifndef FRAMELESSWINDOWMANAGER_H
+#define FRAMELESSWINDOWMANAGER_H
+
+#include <QObject>
+#include <QPointer>
+#include <QHash>
+#include <QList>
+#include <QCoreApplication>
+
+class FramelessHelper;
+
+// Shared state of all frameless windows in the process.
+//
+// A single event filter object serves every window: the host widgets and
+// title bars are registered here and their events are dispatched to the
+// owning FramelessHelper through one hash lookup, instead of each helper and
+// hover reconciler installing filters of their own. Themes and icons are
+// shared through ThemeRegistry and IconCache.
+class FramelessWindowManager : public QObject {
+public:
+    static FramelessWindowManager *instance() {
+        static QPointer<FramelessWindowManager> manager;
+        if (!manager) {
+            manager = new FramelessWindowManager(QCoreApplication::instance());
+        }
+        return manager;
+    }
+
+    void registerWindow(FramelessHelper *helper, QWidget *host, QWidget *titleBar) {
+        m_windows.insert(host, {helper, Host});
+        host->installEventFilter(this);
+        if (titleBar) {
+            m_windows.insert(titleBar, {helper, TitleBar});
+            titleBar->installEventFilter(this);
+        }
+        m_helpers.append(helper);
+    }
+
+    void unregisterWindow(FramelessHelper *helper) {
+        for (auto it = m_windows.begin(); it != m_windows.end();) {
+            if (it.value().helper == helper) {
+                it = m_windows.erase(it);
+            } else {
+                ++it;
+            }
+        }
+        m_helpers.removeAll(helper);
+    }
+
+    QList<FramelessHelper *> windows() const {
+        return m_helpers;
+    }
+
+    int windowCount() const {
+        return m_helpers.size();
+    }
+
+protected:
+    // Defined in framelesshelper.hpp
+    bool eventFilter(QObject *obj, QEvent *event) override;
+
+private:
+    enum Role {
+        Host,
+        TitleBar,
+    };
+
+    struct Entry {
+        FramelessHelper *helper;
+        Role role;
+    };
+
+    explicit FramelessWindowManager(QObject *parent) : QObject(parent) {
+    }
+
+    QHash<QObject *, Entry> m_windows;
+    QList<FramelessHelper *> m_helpers;
+};
+
+#endif // FRAMELESSWINDOWMANAGER_H
@@ -0,0 +1,328 @@
+#ifndef HITTESTMAP_H
+#define HITTESTMAP_H
+
+#include <algorithm>
+
+#include <QObject>
+#include <QPointer>
+#include <QHash>
+#include <QRegion>
+#include <QTimer>
+#include <QVector>
+#include <QWidget>
+#include <QEvent>
+#include <QWKWidgets/widgetwindowagent.h>
+
+// The hit-test visible widgets and system buttons of a frameless title bar,
+// and what the window agent is told about them.
+//
+// On every mouse move over the title bar the agent walks all of its
+// hit-test visible widgets and maps each one to the window. The map keeps
+// the widgets requested through setHitTestVisible() and registers with the
+// agent only the ones that walk needs: hidden, disabled and empty widgets
+// are left out, a widget inside another registered one is covered by it,
+// and children that together fill their parent are replaced by the parent.
+// The registrations are recomputed once per event loop pass after a layout,
+// move, resize, visibility, enabled or screen change of a tracked widget,
+// never per mouse move; until then the agent still walks the previous set.
+//
+// hitTest() answers the same question as the agent from rectangles mapped
+// on that recomputation: a few rectangle checks and one region lookup.
+class HitTestMap : public QObject {
+public:
+    enum Area {
+        Client,
+        Caption,
+        HitTestVisible,
+        SystemButton,
+    };
+
+    struct Result {
+        Area area{Client};
+        QWK::WindowAgentBase::SystemButton button{QWK::WindowAgentBase::Unknown};
+    };
+
+    struct Stats {
+        // Widgets requested to be hit-test visible
+        int requested{0};
+        // Widgets registered with the agent for them
+        int registered{0};
+        // Times the registrations were recomputed
+        int syncs{0};
+    };
+
+    HitTestMap(QWidget *host, QWidget *titleBar, QWK::WidgetWindowAgent *agent)
+        : QObject(titleBar), m_host(host), m_titleBar(titleBar), m_agent(agent) {
+        m_syncTimer.setSingleShot(true);
+        m_syncTimer.setInterval(0);
+        connect(&m_syncTimer, &QTimer::timeout, this, [this]() { sync(); });
+    }
+
+    void setSystemButton(QWK::WindowAgentBase::SystemButton button, QWidget *widget) {
+        m_agent->setSystemButton(button, widget);
+        for (int i = m_buttons.size() - 1; i >= 0; --i) {
+            if (!m_buttons.at(i).widget || m_buttons.at(i).button == button) {
+                m_buttons.removeAt(i);
+            }
+        }
+        if (widget) {
+            m_buttons.append({button, widget, QRect()});
+        }
+        invalidate();
+    }
+
+    void setHitTestVisible(QWidget *widget, bool visible) {
+        m_requested.removeAll(widget);
+        if (visible) {
+            m_requested.append(widget);
+        }
+        invalidate();
+    }
+
+    // Recomputes the registrations on the next event loop pass
+    void invalidate() {
+        m_dirty = true;
+        m_syncTimer.start();
+    }
+
+    // Events of the title bar, dispatched through the FramelessHelper
+    void titleBarEvent(QEvent *event) {
+        if (invalidates(event)) {
+            invalidate();
+        }
+    }
+
+    Result hitTest(const QPoint &pos) {
+        if (m_dirty) {
+            sync();
+        }
+
+        Result result;
+        if (!m_titleBarRect.contains(pos)) {
+            return result;
+        }
+        for (const Button &button : std::as_const(m_buttons)) {
+            if (button.rect.contains(pos)) {
+                result.area = SystemButton;
+                result.button = button.button;
+                return result;
+            }
+        }
+        result.area = m_visibleRegion.contains(pos) ? HitTestVisible : Caption;
+        return result;
+    }
+
+    Stats stats() const {
+        Stats stats = m_stats;
+        stats.requested = int(std::count_if(m_requested.cbegin(), m_requested.cend(),
+                                            [](const QPointer<QWidget> &w) { return !w.isNull(); }));
+        stats.registered = int(std::count_if(m_registered.cbegin(), m_registered.cend(),
+                                             [](const QPointer<QWidget> &w) { return !w.isNull(); }));
+        return stats;
+    }
+
+protected:
+    bool eventFilter(QObject *obj, QEvent *event) override {
+        if (invalidates(event)) {
+            invalidate();
+        }
+        return QObject::eventFilter(obj, event);
+    }
+
+private:
+    struct Button {
+        QWK::WindowAgentBase::SystemButton button;
+        QPointer<QWidget> widget;
+        QRect rect;
+    };
+
+    struct Entry {
+        QWidget *widget;
+        QRect rect;
+    };
+
+    static bool invalidates(const QEvent *event) {
+        switch (event->type()) {
+            case QEvent::Move:
+            case QEvent::Resize:
+            case QEvent::Show:
+            case QEvent::Hide:
+            case QEvent::ShowToParent:
+            case QEvent::HideToParent:
+            case QEvent::EnabledChange:
+            case QEvent::ParentChange:
+            case QEvent::ChildRemoved:
+            case QEvent::LayoutRequest:
+                return true;
+            default:
+                return false;
+        }
+    }
+
+    // Widgets the agent tests at all, as it skips hidden and disabled ones
+    bool isActive(const QWidget *widget) const {
+        return widget->isVisibleTo(m_host) && widget->isEnabled() && !widget->size().isEmpty();
+    }
+
+    QRect mappedRect(const QWidget *widget) const {
+        return QRect(widget->mapTo(m_host, QPoint()), widget->size());
+    }
+
+    // Parents a group of registered children may be replaced with
+    bool canMergeInto(const QWidget *parent) const {
+        return parent && parent != m_titleBar && m_titleBar->isAncestorOf(parent) &&
+               isActive(parent);
+    }
+
+    // Drops the entries inside another one, larger entries first
+    static void dropCovered(QVector<Entry> &entries) {
+        std::stable_sort(entries.begin(), entries.end(), [](const Entry &a, const Entry &b) {
+            return qint64(a.rect.width()) * a.rect.height() >
+                   qint64(b.rect.width()) * b.rect.height();
+        });
+        QVector<Entry> kept;
+        for (const Entry &entry : std::as_const(entries)) {
+            const bool covered = std::any_of(kept.cbegin(), kept.cend(), [&](const Entry &k) {
+                return k.rect.contains(entry.rect);
+            });
+            if (!covered) {
+                kept.append(entry);
+            }
+        }
+        entries = kept;
+    }
+
+    // Replaces children that fill their parent with the parent. Returns
+    // whether any were replaced.
+    bool mergeIntoParents(QVector<Entry> &entries) const {
+        QHash<QWidget *, QVector<int>> groups;
+        for (int i = 0; i < entries.size(); ++i) {
+            QWidget *parent = entries.at(i).widget->parentWidget();
+            if (canMergeInto(parent)) {
+                groups[parent].append(i);
+            }
+        }
+
+        QVector<bool> replaced(entries.size(), false);
+        QVector<Entry> parents;
+        for (auto it = groups.cbegin(); it != groups.cend(); ++it) {
+            const QRect parentRect = mappedRect(it.key());
+            QRegion covered;
+            bool inside = true;
+            for (int i : it.value()) {
+                inside = inside && parentRect.contains(entries.at(i).rect);
+                covered += entries.at(i).rect;
+            }
+            // Children reaching out of the parent are clipped, the parent
+            // alone would not cover those parts
+            if (!inside || !QRegion(parentRect).subtracted(covered).isEmpty())
+                continue;
+            for (int i : it.value()) {
+                replaced[i] = true;
+            }
+            parents.append({it.key(), parentRect});
+        }
+        if (parents.isEmpty())
+            return false;
+
+        QVector<Entry> merged = parents;
+        for (int i = 0; i < entries.size(); ++i) {
+            if (!replaced.at(i)) {
+                merged.append(entries.at(i));
+            }
+        }
+        entries = merged;
+        return true;
+    }
+
+    void sync() {
+        m_dirty = false;
+        m_syncTimer.stop();
+        ++m_stats.syncs;
+        if (!m_host || !m_titleBar) {
+            m_titleBarRect = {};
+            return;
+        }
+
+        m_titleBarRect = m_titleBar->isVisibleTo(m_host) ? mappedRect(m_titleBar) : QRect();
+        for (Button &button : m_buttons) {
+            button.rect = button.widget && isActive(button.widget) ? mappedRect(button.widget)
+                                                                  : QRect();
+        }
+
+        QVector<Entry> entries;
+        m_visibleRegion = QRegion();
+        for (const QPointer<QWidget> &widget : std::as_const(m_requested)) {
+            if (widget && isActive(widget)) {
+                entries.append({widget, mappedRect(widget)});
+                m_visibleRegion += entries.constLast().rect;
+            }
+        }
+        do {
+            dropCovered(entries);
+        } while (mergeIntoParents(entries));
+
+        QVector<QPointer<QWidget>> registered;
+        for (const Entry &entry : std::as_const(entries)) {
+            registered.append(entry.widget);
+        }
+        for (const QPointer<QWidget> &widget : std::as_const(m_registered)) {
+            if (widget && !registered.contains(widget)) {
+                m_agent->setHitTestVisible(widget, false);
+            }
+        }
+        for (const QPointer<QWidget> &widget : std::as_const(registered)) {
+            if (!m_registered.contains(widget)) {
+                m_agent->setHitTestVisible(widget, true);
+            }
+        }
+        m_registered = registered;
+        track();
+    }
+
+    // Watches the requested widgets, the system buttons and the widgets
+    // between them and the title bar, whose geometry moves them
+    void track() {
+        QVector<QPointer<QWidget>> tracked;
+        auto add = [&](QWidget *widget) {
+            for (QWidget *w = widget; w && w != m_titleBar && w != m_host; w = w->parentWidget()) {
+                if (!tracked.contains(w)) {
+                    tracked.append(w);
+                }
+            }
+        };
+        for (const QPointer<QWidget> &widget : std::as_const(m_requested)) {
+            add(widget);
+        }
+        for (const Button &button : std::as_const(m_buttons)) {
+            add(button.widget);
+        }
+
+        for (const QPointer<QWidget> &widget : std::as_const(m_tracked)) {
+            if (widget && !tracked.contains(widget)) {
+                widget->removeEventFilter(this);
+            }
+        }
+        for (const QPointer<QWidget> &widget : std::as_const(tracked)) {
+            if (!m_tracked.contains(widget)) {
+                widget->installEventFilter(this);
+            }
+        }
+        m_tracked = tracked;
+    }
+
+    QPointer<QWidget> m_host;
+    QPointer<QWidget> m_titleBar;
+    QWK::WidgetWindowAgent *m_agent;
+    QVector<Button> m_buttons;
+    QVector<QPointer<QWidget>> m_requested;
+    QVector<QPointer<QWidget>> m_registered;
+    QVector<QPointer<QWidget>> m_tracked;
+    QRect m_titleBarRect;
+    QRegion m_visibleRegion;
+    QTimer m_syncTimer;
+    bool m_dirty{true};
+    Stats m_stats;
+};
+
+#endif // HITTESTMAP_H
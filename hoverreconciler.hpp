@@ -0,0 +1,108 @@
+#ifndef HOVERRECONCILER_H
+#define HOVERRECONCILER_H
+
+#include <QObject>
+#include <QPointer>
+#include <QWidget>
+#include <QCursor>
+#include <QScreen>
+#include <QHoverEvent>
+#include <QAbstractButton>
+#include <QCoreApplication>
+#include <QGuiApplication>
+
+#include <widgetframe/windowbar.h>
+
+// It's a Qt issue that if a title bar button triggers a change of the window
+// geometry (maximize, restore, snapping...), the button remains hovered until
+// the next mouse move.
+//
+// After any geometry change of the host window, reported through hostEvent(),
+// all title bar buttons are checked in one pass on the next event loop
+// iteration with a single cursor query. Only the buttons that are still marked
+// as under the mouse but no longer contain the cursor receive Leave/HoverLeave.
+class HoverReconciler : public QObject {
+public:
+    HoverReconciler(QWidget *host, QWK::WindowBar *bar) : QObject(bar), m_host(host), m_bar(bar) {
+    }
+
+    void hostEvent(QEvent *event) {
+        switch (event->type()) {
+            case QEvent::Move:
+            case QEvent::Resize:
+            case QEvent::WindowStateChange:
+                schedule();
+                break;
+            default:
+                break;
+        }
+    }
+
+    // Requests a pass; several requests before it runs are merged into one
+    void schedule() {
+        if (m_pending)
+            return;
+        m_pending = true;
+        QMetaObject::invokeMethod(this, [this]() { reconcile(); }, Qt::QueuedConnection);
+    }
+
+private:
+    void reconcile() {
+        m_pending = false;
+        if (!m_host || !m_bar || !m_host->isVisible())
+            return;
+
+        const QList<QAbstractButton *> buttons =
+            m_bar->findChildren<QAbstractButton *>(QString(), Qt::FindDirectChildrenOnly);
+
+        bool cursorQueried = false;
+        QPoint globalPos;
+        for (QAbstractButton *button : buttons) {
+            if (!button->underMouse())
+                continue;
+
+            if (!cursorQueried) {
+#if (QT_VERSION >= QT_VERSION_CHECK(5, 14, 0))
+                globalPos = QCursor::pos(m_host->screen());
+#else
+                globalPos = QCursor::pos(m_host->windowHandle()->screen());
+#endif
+                cursorQueried = true;
+            }
+            if (QRect(button->mapToGlobal(QPoint{0, 0}), button->size()).contains(globalPos))
+                continue;
+
+            sendLeave(button, globalPos);
+        }
+    }
+
+    static void sendLeave(QWidget *widget, const QPoint &globalPos) {
+        QEvent leave(QEvent::Leave);
+        QCoreApplication::sendEvent(widget, &leave);
+
+        if (!widget->testAttribute(Qt::WA_Hover))
+            return;
+
+        const QPoint localPos = widget->mapFromGlobal(globalPos);
+        const QPoint scenePos = widget->window()->mapFromGlobal(globalPos);
+        static constexpr const auto oldPos = QPoint{};
+        const Qt::KeyboardModifiers modifiers = QGuiApplication::keyboardModifiers();
+#if (QT_VERSION >= QT_VERSION_CHECK(6, 4, 0))
+        QHoverEvent hoverLeave(QEvent::HoverLeave, scenePos, globalPos, oldPos, modifiers);
+        Q_UNUSED(localPos);
+#elif (QT_VERSION >= QT_VERSION_CHECK(6, 3, 0))
+        QHoverEvent hoverLeave(QEvent::HoverLeave, localPos, globalPos, oldPos, modifiers);
+        Q_UNUSED(scenePos);
+#else
+        QHoverEvent hoverLeave(QEvent::HoverLeave, localPos, oldPos, modifiers);
+        Q_UNUSED(scenePos);
+#endif
+        QCoreApplication::sendEvent(widget, &hoverLeave);
+    }
+
+    QPointer<QWidget> m_host;
+    QPointer<QWK::WindowBar> m_bar;
+    bool m_pending{false};
+};
+
+#endif // HOVERRECONCILER_H
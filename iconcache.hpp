@@ -0,0 +1,242 @@
+#ifndef ICONCACHE_H
+#define ICONCACHE_H
+
+#include <QObject>
+#include <QPointer>
+#include <QHash>
+#include <QIcon>
+#include <QIconEngine>
+#include <QPainter>
+#include <QPixmap>
+#include <QElapsedTimer>
+#include <QCoreApplication>
+
+#include <widgetframe/windowbutton.h>
+
+#include "startuppreloader.hpp"
+
+// Rasterized window-bar icons shared by every window.
+//
+// Each source file is loaded once, and every (file, size, device pixel ratio,
+// mode, state) combination is rasterized once for the whole process. Buttons
+// receive icons backed by CachedIconEngine, so a new button or a DPR change
+// seen before by another window does not touch the SVG renderer again.
+class IconCache : public QObject {
+public:
+    struct Stats {
+        int hits{0};
+        int renders{0};
+        int preloaded{0};
+        qint64 renderNs{0};
+    };
+
+    static IconCache *instance() {
+        static QPointer<IconCache> cache;
+        if (!cache) {
+            cache = new IconCache(QCoreApplication::instance());
+        }
+        return cache;
+    }
+
+    // Shared icon for the file, all callers get the same QIcon instance data
+    QIcon icon(const QString &path);
+
+    QPixmap pixmap(const QString &path, const QSize &size, qreal dpr, QIcon::Mode mode,
+                   QIcon::State state) {
+        const Key key{path, size, dpr, mode, state};
+        auto it = m_pixmaps.constFind(key);
+        if (it != m_pixmaps.constEnd()) {
+            ++m_stats.hits;
+            return it.value();
+        }
+
+        // Rasterized off the GUI thread during startup, single-file icons
+        // look the same in both states
+        if (mode == QIcon::Normal) {
+            const QImage image = StartupPreloader::image(path, size * dpr);
+            if (!image.isNull()) {
+                QPixmap pm = QPixmap::fromImage(image);
+                pm.setDevicePixelRatio(dpr);
+                ++m_stats.preloaded;
+                m_pixmaps.insert(key, pm);
+                return pm;
+            }
+        }
+
+        auto source = m_sources.constFind(path);
+        if (source == m_sources.constEnd()) {
+            source = m_sources.insert(path, QIcon(path));
+        }
+
+        QElapsedTimer timer;
+        timer.start();
+#if QT_VERSION >= QT_VERSION_CHECK(6, 0, 0)
+        QPixmap pm = source->pixmap(size, dpr, mode, state);
+#else
+        QPixmap pm = source->pixmap(size * dpr, mode, state);
+        pm.setDevicePixelRatio(dpr);
+#endif
+        m_stats.renderNs += timer.nsecsElapsed();
+        ++m_stats.renders;
+
+        m_pixmaps.insert(key, pm);
+        return pm;
+    }
+
+    Stats stats() const {
+        return m_stats;
+    }
+
+    void clear() {
+        m_pixmaps.clear();
+        m_sources.clear();
+        m_icons.clear();
+        m_stats = {};
+    }
+
+private:
+#if QT_VERSION >= QT_VERSION_CHECK(6, 0, 0)
+    using HashType = size_t;
+#else
+    using HashType = uint;
+#endif
+
+    struct Key {
+        QString path;
+        QSize size;
+        qreal dpr;
+        QIcon::Mode mode;
+        QIcon::State state;
+
+        // dpr is compared exactly, as it is hashed
+        bool operator==(const Key &other) const {
+            return path == other.path && size == other.size && dpr == other.dpr &&
+                   mode == other.mode && state == other.state;
+        }
+
+        friend HashType qHash(const Key &key, HashType seed = 0) {
+#if QT_VERSION >= QT_VERSION_CHECK(6, 0, 0)
+            return qHashMulti(seed, key.path, key.size.width(), key.size.height(), key.dpr,
+                              int(key.mode), int(key.state));
+#else
+            // Combined the way qHashMulti() does it in Qt 6
+            HashType hash = seed;
+            for (HashType part : {qHash(key.path), qHash(key.size.width()), qHash(key.size.height()),
+                                  qHash(key.dpr), qHash(int(key.mode)), qHash(int(key.state))}) {
+                hash ^= part + 0x9e3779b9 + (hash << 6) + (hash >> 2);
+            }
+            return hash;
+#endif
+        }
+    };
+
+    explicit IconCache(QObject *parent) : QObject(parent) {
+    }
+
+    QHash<QString, QIcon> m_icons;
+    QHash<QString, QIcon> m_sources;
+    QHash<Key, QPixmap> m_pixmaps;
+    Stats m_stats;
+};
+
+class CachedIconEngine : public QIconEngine {
+public:
+    explicit CachedIconEngine(const QString &path) : m_path(path) {
+    }
+
+    void paint(QPainter *painter, const QRect &rect, QIcon::Mode mode,
+               QIcon::State state) override {
+        const qreal dpr = painter->device()->devicePixelRatioF();
+        painter->drawPixmap(rect,
+                            IconCache::instance()->pixmap(m_path, rect.size(), dpr, mode, state));
+    }
+
+    QPixmap pixmap(const QSize &size, QIcon::Mode mode, QIcon::State state) override {
+        return IconCache::instance()->pixmap(m_path, size, 1.0, mode, state);
+    }
+
+#if QT_VERSION >= QT_VERSION_CHECK(6, 0, 0)
+    QPixmap scaledPixmap(const QSize &size, QIcon::Mode mode, QIcon::State state,
+                         qreal scale) override {
+#if QT_VERSION >= QT_VERSION_CHECK(6, 8, 0)
+        return IconCache::instance()->pixmap(m_path, size, scale, mode, state);
+#else
+        // Before 6.8 the size is in device pixels
+        return IconCache::instance()->pixmap(m_path, (QSizeF(size) / scale).toSize(), scale,
+                                             mode, state);
+#endif
+    }
+#endif
+
+    QSize actualSize(const QSize &size, QIcon::Mode mode, QIcon::State state) override {
+        Q_UNUSED(mode);
+        Q_UNUSED(state);
+        return size;
+    }
+
+    QString key() const override {
+        return QStringLiteral("CachedIconEngine");
+    }
+
+    QIconEngine *clone() const override {
+        return new CachedIconEngine(m_path);
+    }
+
+private:
+    QString m_path;
+};
+
+inline QIcon IconCache::icon(const QString &path) {
+    auto it = m_icons.constFind(path);
+    if (it == m_icons.constEnd()) {
+        it = m_icons.insert(path, QIcon(new CachedIconEngine(path)));
+    }
+    return it.value();
+}
+
+// The icons of the WindowBar buttons, by object name. Mirrors the
+// qproperty-iconNormal/iconChecked rules of the qss.
+struct WindowBarIcons {
+    const char *normal;
+    const char *checked;
+
+    static WindowBarIcons forButton(const QString &objectName) {
+        if (objectName == QStringLiteral("icon-button"))
+            return {":/app/example.png", nullptr};
+        if (objectName == QStringLiteral("min-button"))
+            return {":/window-bar/minimize.svg", nullptr};
+        if (objectName == QStringLiteral("max-button"))
+            return {":/window-bar/maximize.svg", ":/window-bar/restore.svg"};
+        if (objectName == QStringLiteral("close-button"))
+            return {":/window-bar/close.svg", nullptr};
+        if (objectName == QStringLiteral("pin-button"))
+            return {":/window-bar/pin.svg", ":/window-bar/pin-fill.svg"};
+        return {nullptr, nullptr};
+    }
+
+    // Vector icons of the system buttons at the qss icon size, rasterized by
+    // the StartupPreloader
+    static QVector<StartupPreloader::Image> startupImages() {
+        const QSize iconSize(12, 12);
+        return {
+            {QStringLiteral(":/window-bar/minimize.svg"), iconSize},
+            {QStringLiteral(":/window-bar/maximize.svg"), iconSize},
+            {QStringLiteral(":/window-bar/restore.svg"), iconSize},
+            {QStringLiteral(":/window-bar/close.svg"), iconSize},
+        };
+    }
+
+    // Replaces the per-button icons created by the qss or the style with the
+    // shared cached ones
+    static void apply(QWK::WindowButton *button) {
+        const WindowBarIcons icons = forButton(button->objectName());
+        if (icons.normal) {
+            button->setIconNormal(IconCache::instance()->icon(QString::fromLatin1(icons.normal)));
+        }
+        if (icons.checked) {
+            button->setIconChecked(IconCache::instance()->icon(QString::fromLatin1(icons.checked)));
+        }
+    }
+};
+
+#endif // ICONCACHE_H
@@ -2,9 +2,14 @@
 // Copyright (C) 2021-2023 wangwenx190 (Yuhang Zhao)
 // SPDX-License-Identifier: Apache-2.0
 
+#include <QtGui/QScreen>
 #include <QtWidgets/QApplication>
 
 #include "framelesswindow.h"
+#include "startuppreloader.hpp"
+#include "stallwatchdog.hpp"
+#include "tracer.hpp"
+#include "eventrecorder.hpp"
 
 int main(int argc, char *argv[]) {
     qputenv("QT_WIN_DEBUG_CONSOLE", "attach");
@@ -14,6 +19,7 @@ int main(int argc, char *argv[]) {
     //qputenv("QSG_RHI_BACKEND", "d3d12");
     //qputenv("QSG_RHI_HDR", "scrgb");
     //qputenv("QT_QPA_DISABLE_REDIRECTION_SURFACE", "1");
+    //qputenv("QWK_TRACE", "trace.json");
 
 #if QT_VERSION >= QT_VERSION_CHECK(5, 14, 0)
     QGuiApplication::setHighDpiScaleFactorRoundingPolicy(
@@ -25,10 +31,22 @@ int main(int argc, char *argv[]) {
 #endif
 
     QCoreApplication::setAttribute(Qt::AA_DontCreateNativeWidgetSiblings);
+
+    Tracer::start();
     QApplication a(argc, argv);
+    StallWatchdog::startFromEnvironment();
+
+    // Decode the qss and the window-bar icons while the window is built
+    StartupPreloader::start(
+        ThemeRegistry::styleSheetPaths(Dark) + ThemeRegistry::styleSheetPaths(Light),
+        WindowBarIcons::startupImages(), QGuiApplication::primaryScreen()->devicePixelRatio());
 
     FramelessWindow w;
     w.show();
+    EventRecorder::startFromEnvironment(&w);
+    EventReplayer::startFromEnvironment(&w);
 
-    return a.exec();
+    const int result = a.exec();
+    Tracer::finish();
+    return result;
 }
@@ -0,0 +1,95 @@
+#ifndef MEMORYREPORT_H
+#define MEMORYREPORT_H
+
+#include <QObject>
+#include <QWidget>
+#include <QHash>
+#include <QString>
+
+#if defined(Q_OS_WIN)
+#  include <malloc.h>
+#elif defined(Q_OS_MAC)
+#  include <malloc/malloc.h>
+#elif defined(__GLIBC__)
+#  include <malloc.h>
+#endif
+
+// Bytes currently allocated from the C runtime heap, or -1 where the platform
+// offers no way to ask. Meant for deltas around a construction on the GUI
+// thread, not as an absolute figure.
+static inline qint64 currentHeapBytes() {
+#if defined(Q_OS_WIN)
+    qint64 total = 0;
+    _HEAPINFO info;
+    info._pentry = nullptr;
+    int status;
+    while ((status = _heapwalk(&info)) == _HEAPOK) {
+        if (info._useflag == _USEDENTRY) {
+            total += qint64(info._size);
+        }
+    }
+    return (status == _HEAPEND || status == _HEAPEMPTY) ? total : -1;
+#elif defined(Q_OS_MAC)
+    malloc_statistics_t stats;
+    malloc_zone_statistics(nullptr, &stats);
+    return qint64(stats.size_in_use);
+#elif defined(__GLIBC__) && (__GLIBC__ > 2 || (__GLIBC__ == 2 && __GLIBC_MINOR__ >= 33))
+    return qint64(mallinfo2().uordblks);
+#elif defined(__GLIBC__)
+    return qint64(mallinfo().uordblks);
+#else
+    return -1;
+#endif
+}
+
+// Heap measurements walk the allocator and are only taken when the
+// QWK_MEMORY_REPORT environment variable is set
+static inline bool heapAccountingEnabled() {
+    static const bool enabled = !qEnvironmentVariableIsEmpty("QWK_MEMORY_REPORT");
+    return enabled;
+}
+
+// What a frameless window or dialog holds, see FramelessHelper::memoryReport()
+struct FramelessMemoryReport {
+    // QObjects in the window tree, the window itself included. Child windows,
+    // such as the pooled dialogs, are not part of it.
+    int objects{0};
+    int widgets{0};
+    // Child windows and the QObjects in their trees, counted apart
+    int childWindows{0};
+    int childWindowObjects{0};
+    // Heap growth measured only while the FramelessHelper installed the window
+    // agent and style sheet and built the title bar parts. What the window and
+    // its content allocate outside of that is not included. -1 when heap
+    // accounting is disabled or unsupported.
+    qint64 heapBytes{-1};
+    // Object count per class name, window tree only
+    QHash<QString, int> classes;
+
+    static FramelessMemoryReport collect(const QWidget *window, qint64 heapBytes) {
+        FramelessMemoryReport report;
+        report.heapBytes = heapBytes;
+        report.add(window);
+        return report;
+    }
+
+private:
+    void add(const QObject *obj) {
+        ++objects;
+        if (obj->isWidgetType()) {
+            ++widgets;
+        }
+        ++classes[QString::fromLatin1(obj->metaObject()->className())];
+
+        for (const QObject *child : obj->children()) {
+            if (child->isWidgetType() && static_cast<const QWidget *>(child)->isWindow()) {
+                ++childWindows;
+                childWindowObjects += 1 + child->findChildren<QObject *>().size();
+            } else {
+                add(child);
+            }
+        }
+    }
+};
+
+#endif // MEMORYREPORT_H
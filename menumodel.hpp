@@ -0,0 +1,200 @@
+#ifndef MENUMODEL_H
+#define MENUMODEL_H
+
+#include <functional>
+
+#include <QObject>
+#include <QHash>
+#include <QFile>
+#include <QMenu>
+#include <QMenuBar>
+#include <QAction>
+#include <QJsonArray>
+#include <QJsonObject>
+#include <QJsonDocument>
+#include <QKeySequence>
+#include <QCoreApplication>
+#if QT_VERSION >= QT_VERSION_CHECK(6, 0, 0)
+#  include <QtGui/QActionGroup>
+#else
+#  include <QtWidgets/QActionGroup>
+#endif
+
+// A menu bar described by a JSON resource:
+//
+//     { "menus": [ { "title": "File(&F)", "items": [
+//         { "id": "new", "text": "New(&N)", "shortcut": "Ctrl+N" },
+//         { "separator": true },
+//         { "title": "Recent", "items": [ ... ] },
+//         { "id": "mica", "text": "Enable mica", "group": "window-style",
+//           "data": "mica", "platforms": ["windows"] } ] } ] }
+//
+// The top-level menus are added to the menu bar right away. The actions of a
+// menu, its submenus included, are only created when the menu is about to be
+// shown for the first time, so shortcuts of a menu that was never opened are
+// not active yet. Items sharing a "group" within one menu form an exclusive
+// QActionGroup.
+//
+// Behaviour is attached by id: a binding runs once, when its action or group
+// has been created. A menu binding runs for every menu, before it is shown.
+//
+// Texts are looked up with QCoreApplication::translate() in the given context.
+// lupdate does not read the JSON, so the owner lists the texts with
+// QT_TRANSLATE_NOOP in the same context.
+class MenuModel : public QObject {
+public:
+    using ActionBinding = std::function<void(QAction *)>;
+    using GroupBinding = std::function<void(QActionGroup *)>;
+    using MenuBinding = std::function<void(QMenu *)>;
+
+    MenuModel(const QString &resource, QMenuBar *menuBar, const char *context)
+        : QObject(menuBar), m_context(context) {
+        QFile file(resource);
+        if (!file.open(QIODevice::ReadOnly)) {
+            qWarning("MenuModel: cannot open %s", qPrintable(resource));
+            return;
+        }
+        QJsonParseError error;
+        const QJsonDocument document = QJsonDocument::fromJson(file.readAll(), &error);
+        if (error.error != QJsonParseError::NoError) {
+            qWarning("MenuModel: %s: %s", qPrintable(resource), qPrintable(error.errorString()));
+            return;
+        }
+
+        const QJsonArray menus = document.object().value(QStringLiteral("menus")).toArray();
+        for (const QJsonValue &value : menus) {
+            const QJsonObject entry = value.toObject();
+            if (isAvailable(entry)) {
+                menuBar->addMenu(createMenu(entry, menuBar));
+            }
+        }
+    }
+
+    void bind(const QString &id, ActionBinding binding) {
+        m_actionBindings.insert(id, std::move(binding));
+    }
+
+    void bindGroup(const QString &name, GroupBinding binding) {
+        m_groupBindings.insert(name, std::move(binding));
+    }
+
+    // Runs for the menus created so far and for each submenu once it is created
+    void bindMenus(MenuBinding binding) {
+        m_menuBinding = std::move(binding);
+        if (!m_menuBinding)
+            return;
+        for (QMenu *menu : parent()->findChildren<QMenu *>()) {
+            m_menuBinding(menu);
+        }
+    }
+
+    // nullptr until the menu of the action has been shown
+    QAction *action(const QString &id) const {
+        return m_actions.value(id);
+    }
+
+    // Actions created so far
+    int actionCount() const {
+        return m_actionCount;
+    }
+
+private:
+    QMenu *createMenu(const QJsonObject &entry, QWidget *parent) {
+        auto menu = new QMenu(translate(entry.value(QStringLiteral("title")).toString()), parent);
+        m_pending.insert(menu, entry.value(QStringLiteral("items")).toArray());
+        if (m_menuBinding) {
+            m_menuBinding(menu);
+        }
+        connect(menu, &QMenu::aboutToShow, this, [this, menu]() {
+            auto it = m_pending.find(menu);
+            if (it == m_pending.end())
+                return;
+            const QJsonArray items = it.value();
+            m_pending.erase(it);
+            populate(menu, items);
+        });
+        return menu;
+    }
+
+    void populate(QMenu *menu, const QJsonArray &items) {
+        QHash<QString, QActionGroup *> groups;
+        for (const QJsonValue &value : items) {
+            const QJsonObject item = value.toObject();
+            if (!isAvailable(item))
+                continue;
+
+            if (item.value(QStringLiteral("separator")).toBool()) {
+                menu->addSeparator();
+                continue;
+            }
+            if (item.contains(QStringLiteral("items"))) {
+                menu->addMenu(createMenu(item, menu));
+                continue;
+            }
+
+            auto action = new QAction(translate(item.value(QStringLiteral("text")).toString()), menu);
+            const QString group = item.value(QStringLiteral("group")).toString();
+            action->setCheckable(!group.isEmpty() || item.value(QStringLiteral("checkable")).toBool());
+            action->setChecked(item.value(QStringLiteral("checked")).toBool());
+            if (item.contains(QStringLiteral("data"))) {
+                action->setData(item.value(QStringLiteral("data")).toVariant());
+            }
+            if (item.contains(QStringLiteral("shortcut"))) {
+                action->setShortcut(QKeySequence(item.value(QStringLiteral("shortcut")).toString()));
+            }
+            menu->addAction(action);
+            ++m_actionCount;
+
+            if (!group.isEmpty()) {
+                QActionGroup *&actionGroup = groups[group];
+                if (!actionGroup) {
+                    actionGroup = new QActionGroup(menu);
+                }
+                actionGroup->addAction(action);
+            }
+
+            const QString id = item.value(QStringLiteral("id")).toString();
+            if (!id.isEmpty()) {
+                m_actions.insert(id, action);
+                if (const ActionBinding binding = m_actionBindings.value(id)) {
+                    binding(action);
+                }
+            }
+        }
+
+        // The group bindings see all of their actions
+        for (auto it = groups.cbegin(); it != groups.cend(); ++it) {
+            if (const GroupBinding binding = m_groupBindings.value(it.key())) {
+                binding(it.value());
+            }
+        }
+    }
+
+    QString translate(const QString &text) const {
+        return QCoreApplication::translate(m_context, text.toUtf8().constData());
+    }
+
+    static bool isAvailable(const QJsonObject &entry) {
+        const QJsonValue platforms = entry.value(QStringLiteral("platforms"));
+        if (platforms.isUndefined())
+            return true;
+#if defined(Q_OS_WIN)
+        static const QString platform = QStringLiteral("windows");
+#elif defined(Q_OS_MAC)
+        static const QString platform = QStringLiteral("mac");
+#else
+        static const QString platform = QStringLiteral("linux");
+#endif
+        return platforms.toArray().contains(platform);
+    }
+
+    const char *m_context;
+    QHash<QMenu *, QJsonArray> m_pending;
+    QHash<QString, QAction *> m_actions;
+    QHash<QString, ActionBinding> m_actionBindings;
+    QHash<QString, GroupBinding> m_groupBindings;
+    MenuBinding m_menuBinding;
+    int m_actionCount{0};
+};
+
+#endif // MENUMODEL_H
@@ -0,0 +1,49 @@
+# Menus of the main window and a check of their texts
+#
+# MenuModel translates the texts of mainwindow.json at run time, but lupdate
+# does not read the JSON: it takes the texts from the QT_TRANSLATE_NOOP list
+# MenuTexts in framelesswindow.cpp. A text of the JSON missing from the list,
+# or one in the list the JSON no longer uses, stops qmake with an error.
+
+MENU_JSON = $$PWD/mainwindow.json
+MENU_SOURCE = $$PWD/../framelesswindow.cpp
+
+# Texts are compared reduced to letters, digits and underscores, which keeps
+# them single list items and free of regular expression characters
+
+MENU_JSON_TEXTS =
+MENU_JSON_LINES = $$cat($$MENU_JSON, lines)
+for(line, MENU_JSON_LINES) {
+    contains(line, ".*\"(text|title)\"\\s*:.*") {
+        MENU_TEXT = $$replace(line, ".*\"(text|title)\"\\s*:\\s*\"([^\"]*)\".*", "\\2")
+        MENU_JSON_TEXTS += $$replace(MENU_TEXT, "[^A-Za-z0-9]", "_")
+    }
+}
+
+MENU_SOURCE_TEXTS =
+MENU_SOURCE_LINES = $$cat($$MENU_SOURCE, lines)
+for(line, MENU_SOURCE_LINES) {
+    contains(line, ".*QT_TRANSLATE_NOOP\\(\"FramelessWindow\",.*") {
+        MENU_TEXT = $$replace(line, ".*QT_TRANSLATE_NOOP\\(\"FramelessWindow\",\\s*\"([^\"]*)\"\\).*", "\\1")
+        MENU_SOURCE_TEXTS += $$replace(MENU_TEXT, "[^A-Za-z0-9]", "_")
+    }
+}
+
+isEmpty(MENU_JSON_TEXTS) {
+    error("mainwindow.json: no menu texts found")
+}
+for(text, MENU_JSON_TEXTS) {
+    !contains(MENU_SOURCE_TEXTS, $$text) {
+        error("framelesswindow.cpp: MenuTexts lacks the mainwindow.json text $$text")
+    }
+}
+for(text, MENU_SOURCE_TEXTS) {
+    !contains(MENU_JSON_TEXTS, $$text) {
+        error("framelesswindow.cpp: MenuTexts has $$text, which mainwindow.json does not use")
+    }
+}
+
+# Re-run qmake when either side changes
+QMAKE_INTERNAL_INCLUDED_FILES += $$MENU_JSON $$MENU_SOURCE
+
+RESOURCES += $$PWD/menus.qrc
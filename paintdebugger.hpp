@@ -0,0 +1,147 @@
+#ifndef PAINTDEBUGGER_H
+#define PAINTDEBUGGER_H
+
+#include <QObject>
+#include <QPointer>
+#include <QWidget>
+#include <QRegion>
+#include <QVector>
+#include <QTimer>
+#include <QPainter>
+#include <QPaintEvent>
+#include <QCoreApplication>
+
+// Dirty region debugging, enabled by the QWK_PAINT_DEBUG environment variable.
+//
+// Every paint event of a window is recorded in window coordinates and grouped
+// into frames, one frame being all paints of one event loop pass. The region
+// of the last frame is shown in a click-through overlay window above the
+// window, so repaints that are larger than the change behind them stand out.
+// The overlay is a separate top-level window, its own repaints never dirty
+// the watched window. frames() keeps the most recent frames for inspection.
+class PaintDebugger : public QObject {
+public:
+    struct Frame {
+        QRegion region;
+        int paintEvents{0};
+        // Pixels painted, overlapping paints counted once
+        qint64 area{0};
+    };
+
+    struct Stats {
+        int frames{0};
+        int paintEvents{0};
+        qint64 area{0};
+        qint64 maxFrameArea{0};
+    };
+
+    static bool isEnabled() {
+        static const bool enabled = !qEnvironmentVariableIsEmpty("QWK_PAINT_DEBUG");
+        return enabled;
+    }
+
+    explicit PaintDebugger(QWidget *window) : QObject(window), m_window(window) {
+        // Paints of any widget of the window, including ones created later
+        QCoreApplication::instance()->installEventFilter(this);
+    }
+
+    ~PaintDebugger() override {
+        delete m_overlay;
+    }
+
+    QVector<Frame> frames() const {
+        return m_frames;
+    }
+
+    Stats stats() const {
+        return m_stats;
+    }
+
+protected:
+    bool eventFilter(QObject *obj, QEvent *event) override {
+        if (event->type() != QEvent::Paint || !obj->isWidgetType())
+            return false;
+
+        auto widget = static_cast<QWidget *>(obj);
+        if (widget->window() != m_window)
+            return false;
+
+        const QRegion region = static_cast<QPaintEvent *>(event)->region();
+        if (m_current.paintEvents == 0) {
+            QTimer::singleShot(0, this, [this]() { finishFrame(); });
+        }
+        m_current.region += region.translated(widget->mapTo(m_window, QPoint()));
+        ++m_current.paintEvents;
+        return false;
+    }
+
+private:
+    class Overlay : public QWidget {
+    public:
+        explicit Overlay(QWidget *window)
+            : QWidget(window, Qt::ToolTip | Qt::FramelessWindowHint | Qt::WindowTransparentForInput) {
+            setAttribute(Qt::WA_TranslucentBackground);
+            setAttribute(Qt::WA_ShowWithoutActivating);
+            setAttribute(Qt::WA_TransparentForMouseEvents);
+        }
+
+        void showRegion(const QWidget *window, const QRegion &region) {
+            m_region = region;
+            setGeometry(QRect(window->mapToGlobal(QPoint()), window->size()));
+            if (!isVisible()) {
+                show();
+            }
+            update();
+        }
+
+    protected:
+        void paintEvent(QPaintEvent *event) override {
+            Q_UNUSED(event);
+            QPainter painter(this);
+            painter.setCompositionMode(QPainter::CompositionMode_Source);
+            painter.fillRect(rect(), Qt::transparent);
+            for (const QRect &rect : m_region) {
+                painter.fillRect(rect, QColor(255, 0, 255, 60));
+                painter.setPen(QColor(255, 0, 255, 200));
+                painter.drawRect(rect.adjusted(0, 0, -1, -1));
+            }
+        }
+
+    private:
+        QRegion m_region;
+    };
+
+    void finishFrame() {
+        for (const QRect &rect : m_current.region) {
+            m_current.area += qint64(rect.width()) * rect.height();
+        }
+
+        ++m_stats.frames;
+        m_stats.paintEvents += m_current.paintEvents;
+        m_stats.area += m_current.area;
+        m_stats.maxFrameArea = qMax(m_stats.maxFrameArea, m_current.area);
+
+        if (m_frames.size() == MaxFrames) {
+            m_frames.removeFirst();
+        }
+        m_frames.append(m_current);
+
+        if (m_window && m_window->isVisible()) {
+            if (!m_overlay) {
+                m_overlay = new Overlay(m_window);
+            }
+            m_overlay->showRegion(m_window, m_current.region);
+        }
+        m_current = {};
+    }
+
+    static constexpr const int MaxFrames = 120;
+
+    QPointer<QWidget> m_window;
+    QPointer<Overlay> m_overlay;
+    Frame m_current;
+    QVector<Frame> m_frames;
+    Stats m_stats;
+};
+
+#endif // PAINTDEBUGGER_H
@@ -0,0 +1,116 @@
+#ifndef SCREENCHANGECOALESCER_H
+#define SCREENCHANGECOALESCER_H
+
+#include <functional>
+
+#include <QObject>
+#include <QPointer>
+#include <QWidget>
+#include <QLayout>
+#include <QTimer>
+#include <QEvent>
+
+// A window dragged across monitors with different scaling gets a screen
+// change, and with PassThrough scaling usually a device pixel ratio change,
+// every time it crosses a border, often several per drag. Each one makes the
+// title bar children pick up new font metrics and icon sizes and relayout the
+// bar, and the following move makes the window bar relayout again.
+//
+// While the window is crossing, the layout of the title bar is disabled so the
+// intermediate layout requests are dropped. Once the window has not changed
+// screen, ratio or position for settleDelay() milliseconds, the layout is
+// enabled and activated once and the settle callback does the one re-render.
+// A resize of the host cannot wait, it settles right away.
+class ScreenChangeCoalescer : public QObject {
+public:
+    struct Stats {
+        // Screen and ratio changes received
+        int notifications{0};
+        // Times the window settled, each with one relayout
+        int settles{0};
+    };
+
+    ScreenChangeCoalescer(QWidget *host, QWidget *titleBar, std::function<void()> onSettled)
+        : QObject(titleBar), m_host(host), m_titleBar(titleBar), m_onSettled(std::move(onSettled)) {
+        m_timer.setSingleShot(true);
+        m_timer.setInterval(100);
+        connect(&m_timer, &QTimer::timeout, this, [this]() { settle(); });
+    }
+
+    int settleDelay() const {
+        return m_timer.interval();
+    }
+
+    void setSettleDelay(int ms) {
+        m_timer.setInterval(ms);
+    }
+
+    bool isPending() const {
+        return m_timer.isActive();
+    }
+
+    Stats stats() const {
+        return m_stats;
+    }
+
+    // Events of the host, seen before the host handles them
+    void hostEvent(QEvent *event) {
+        switch (event->type()) {
+            case QEvent::ScreenChangeInternal:
+#if QT_VERSION >= QT_VERSION_CHECK(6, 6, 0)
+            case QEvent::DevicePixelRatioChange:
+#endif
+                // The first screen is set while the window is created
+                if (!m_host->isVisible())
+                    break;
+                ++m_stats.notifications;
+                if (!isPending()) {
+                    setLayoutEnabled(false);
+                }
+                m_timer.start();
+                break;
+            case QEvent::Move:
+                if (isPending()) {
+                    m_timer.start();
+                }
+                break;
+            case QEvent::Resize:
+                if (isPending()) {
+                    m_timer.stop();
+                    settle();
+                }
+                break;
+            default:
+                break;
+        }
+    }
+
+private:
+    void setLayoutEnabled(bool enabled) {
+        if (QLayout *layout = m_titleBar ? m_titleBar->layout() : nullptr) {
+            layout->setEnabled(enabled);
+        }
+    }
+
+    void settle() {
+        if (!m_host || !m_titleBar)
+            return;
+        ++m_stats.settles;
+        setLayoutEnabled(true);
+        if (QLayout *layout = m_titleBar->layout()) {
+            layout->invalidate();
+            layout->activate();
+        }
+        if (m_onSettled) {
+            m_onSettled();
+        }
+    }
+
+    QPointer<QWidget> m_host;
+    QPointer<QWidget> m_titleBar;
+    std::function<void()> m_onSettled;
+    QTimer m_timer;
+    Stats m_stats;
+};
+
+#endif // SCREENCHANGECOALESCER_H
@@ -0,0 +1,212 @@
+#ifndef STALLWATCHDOG_H
+#define STALLWATCHDOG_H
+
+#include <atomic>
+
+#include <QObject>
+#include <QPointer>
+#include <QThread>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QVector>
+#include <QMetaEnum>
+#include <QElapsedTimer>
+#include <QAbstractEventDispatcher>
+#include <QCoreApplication>
+
+// Detects GUI thread stalls and attributes them to the event being handled.
+//
+// The GUI thread notes the start of every event it delivers (an application
+// event filter) and whether its event loop is blocked waiting for work. A
+// monitor thread wakes up a few times per threshold; if the GUI thread has
+// been busy with the same event for longer than the threshold, the stall is
+// logged right away with the event type, receiver class and object name.
+// When the GUI thread moves on, the full duration is added to stats().
+//
+// The attribution is the most recently started event, so a handler that
+// keeps running after sending nested events is reported under the last
+// nested one. Started by QWK_STALL_THRESHOLD_MS=<ms> or by start().
+class StallWatchdog : public QObject {
+public:
+    struct Stall {
+        QString event;
+        QString receiver;
+        qint64 durationNs{0};
+    };
+
+    struct Stats {
+        int stalls{0};
+        qint64 totalNs{0};
+        qint64 maxNs{0};
+        // The most recent stalls, oldest first
+        QVector<Stall> recent;
+    };
+
+    static StallWatchdog *instance() {
+        static QPointer<StallWatchdog> watchdog;
+        if (!watchdog) {
+            watchdog = new StallWatchdog(QCoreApplication::instance());
+        }
+        return watchdog;
+    }
+
+    ~StallWatchdog() override {
+        stop();
+    }
+
+    // Starts the watchdog if QWK_STALL_THRESHOLD_MS is set
+    static void startFromEnvironment() {
+        bool ok = false;
+        const int threshold = qEnvironmentVariableIntValue("QWK_STALL_THRESHOLD_MS", &ok);
+        if (ok && threshold > 0) {
+            instance()->start(threshold);
+        }
+    }
+
+    void start(int thresholdMs) {
+        if (m_monitor)
+            return;
+        m_thresholdNs = qint64(thresholdMs) * 1000000;
+        m_busy = true;
+        markEvent(QEvent::None, nullptr);
+
+        QCoreApplication::instance()->installEventFilter(this);
+        if (auto dispatcher = QAbstractEventDispatcher::instance(thread())) {
+            m_aboutToBlock = connect(dispatcher, &QAbstractEventDispatcher::aboutToBlock, this,
+                                     [this]() { idle(); }, Qt::DirectConnection);
+            m_awake = connect(dispatcher, &QAbstractEventDispatcher::awake, this,
+                              [this]() { markEvent(QEvent::None, nullptr); }, Qt::DirectConnection);
+        }
+
+        m_running = true;
+        const unsigned long interval = qMax(5, thresholdMs / 4);
+        m_monitor = QThread::create([this, interval]() {
+            while (m_running) {
+                QThread::msleep(interval);
+                check();
+            }
+        });
+        m_monitor->setObjectName(QStringLiteral("StallWatchdog"));
+        m_monitor->start(QThread::HighPriority);
+    }
+
+    void stop() {
+        if (!m_monitor)
+            return;
+        m_running = false;
+        m_monitor->wait();
+        delete m_monitor;
+        m_monitor = nullptr;
+
+        QCoreApplication::instance()->removeEventFilter(this);
+        disconnect(m_aboutToBlock);
+        disconnect(m_awake);
+    }
+
+    bool isRunning() const {
+        return m_monitor;
+    }
+
+    Stats stats() const {
+        QMutexLocker locker(&m_mutex);
+        return m_stats;
+    }
+
+protected:
+    bool eventFilter(QObject *obj, QEvent *event) override {
+        markEvent(event->type(), obj);
+        return false;
+    }
+
+private:
+    explicit StallWatchdog(QObject *parent) : QObject(parent) {
+        m_clock.start();
+    }
+
+    // GUI thread
+    void markEvent(int type, const QObject *receiver) {
+        QMutexLocker locker(&m_mutex);
+        finishStall();
+        m_busy = true;
+        m_current.type = type;
+        m_current.start = m_clock.nsecsElapsed();
+        m_current.className = receiver ? receiver->metaObject()->className() : nullptr;
+        m_current.objectName = receiver ? receiver->objectName() : QString();
+    }
+
+    void idle() {
+        QMutexLocker locker(&m_mutex);
+        finishStall();
+        m_busy = false;
+    }
+
+    void finishStall() {
+        if (!m_current.stalled)
+            return;
+        m_current.stalled = false;
+
+        Stall stall = describe(m_current);
+        stall.durationNs = m_clock.nsecsElapsed() - m_current.start;
+        ++m_stats.stalls;
+        m_stats.totalNs += stall.durationNs;
+        m_stats.maxNs = qMax(m_stats.maxNs, stall.durationNs);
+        if (m_stats.recent.size() == MaxRecent) {
+            m_stats.recent.removeFirst();
+        }
+        m_stats.recent.append(stall);
+    }
+
+    // Monitor thread
+    void check() {
+        QMutexLocker locker(&m_mutex);
+        if (!m_busy || m_current.stalled)
+            return;
+        const qint64 elapsed = m_clock.nsecsElapsed() - m_current.start;
+        if (elapsed < m_thresholdNs)
+            return;
+
+        m_current.stalled = true;
+        const Stall stall = describe(m_current);
+        locker.unlock();
+        qWarning("StallWatchdog: GUI thread busy for %lld ms in %s to %s", elapsed / 1000000,
+                 qPrintable(stall.event), qPrintable(stall.receiver));
+    }
+
+    struct Current {
+        int type{QEvent::None};
+        qint64 start{0};
+        const char *className{nullptr};
+        QString objectName;
+        bool stalled{false};
+    };
+
+    static Stall describe(const Current &current) {
+        Stall stall;
+        if (current.type == QEvent::None && !current.className) {
+            stall.event = QStringLiteral("event loop");
+        } else {
+            const char *name = QMetaEnum::fromType<QEvent::Type>().valueToKey(current.type);
+            stall.event = name ? QString::fromLatin1(name) : QString::number(current.type);
+        }
+        stall.receiver = current.className ? QString::fromLatin1(current.className) : QStringLiteral("-");
+        if (!current.objectName.isEmpty()) {
+            stall.receiver += QStringLiteral(" \"%1\"").arg(current.objectName);
+        }
+        return stall;
+    }
+
+    static constexpr const int MaxRecent = 32;
+
+    mutable QMutex m_mutex;
+    QElapsedTimer m_clock;
+    QThread *m_monitor{nullptr};
+    std::atomic<bool> m_running{false};
+    qint64 m_thresholdNs{0};
+    bool m_busy{false};
+    Current m_current;
+    Stats m_stats;
+    QMetaObject::Connection m_aboutToBlock;
+    QMetaObject::Connection m_awake;
+};
+
+#endif // STALLWATCHDOG_H
@@ -0,0 +1,106 @@
+#ifndef STARTUPPRELOADER_H
+#define STARTUPPRELOADER_H
+
+#include <QFile>
+#include <QHash>
+#include <QImage>
+#include <QImageReader>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QThread>
+#include <QVector>
+#include <QCoreApplication>
+
+#include "startupprofiler.hpp"
+
+// Reads and decodes the startup resources on a worker thread: the theme
+// sheets (qrc decompression and UTF-8 decoding) and the window-bar SVGs,
+// rasterized at the device pixel ratio of the primary screen. Started from
+// main() right after QApplication, it overlaps with the construction of the
+// first window.
+//
+// Consumers look results up with styleSheet() and image(). Anything that is
+// not ready yet is loaded synchronously by the caller exactly as without
+// preloading and the late result of the worker goes unused, so the GUI thread
+// never waits for the worker and a first paint that comes early is not
+// delayed. Set QWK_NO_PRELOAD to compare time-to-first-frame without it (see
+// bench/startup/); the "preload" phase is only reported if the worker
+// finished before the first frame.
+class StartupPreloader {
+public:
+    struct Image {
+        QString path;
+        QSize size;
+    };
+
+    static void start(const QStringList &styleSheets, const QVector<Image> &images, qreal dpr) {
+        if (!qEnvironmentVariableIsEmpty("QWK_NO_PRELOAD"))
+            return;
+
+        const bool profiling = StartupProfiler::isEnabled();
+        QThread *thread = QThread::create([styleSheets, images, dpr, profiling]() {
+            const qint64 start = profiling ? StartupProfiler::now() : 0;
+            for (const QString &path : styleSheets) {
+                QFile qss(path);
+                if (qss.open(QIODevice::ReadOnly | QIODevice::Text)) {
+                    const QString sheet = QString::fromUtf8(qss.readAll());
+                    QMutexLocker locker(&state().mutex);
+                    state().styleSheets.insert(path, sheet);
+                }
+            }
+            for (const Image &request : images) {
+                const QSize pixelSize = request.size * dpr;
+                QImageReader reader(request.path);
+                reader.setScaledSize(pixelSize);
+                const QImage image = reader.read().convertToFormat(QImage::Format_ARGB32_Premultiplied);
+                if (!image.isNull()) {
+                    QMutexLocker locker(&state().mutex);
+                    state().images.insert(imageKey(request.path, pixelSize), image);
+                }
+            }
+            if (!profiling)
+                return;
+            const qint64 end = StartupProfiler::now();
+            QMetaObject::invokeMethod(
+                QCoreApplication::instance(),
+                [start, end]() { StartupProfiler::record("preload", start, end); },
+                Qt::QueuedConnection);
+        });
+        thread->setObjectName(QStringLiteral("StartupPreloader"));
+        QObject::connect(thread, &QThread::finished, thread, &QObject::deleteLater);
+        QObject::connect(QCoreApplication::instance(), &QCoreApplication::aboutToQuit, thread,
+                         [thread]() { thread->wait(); });
+        thread->start(QThread::HighPriority);
+    }
+
+    // Null if the sheet was not preloaded or is not decoded yet
+    static QString styleSheet(const QString &path) {
+        QMutexLocker locker(&state().mutex);
+        return state().styleSheets.value(path);
+    }
+
+    // Null if the image was not preloaded at this pixel size or is not ready yet
+    static QImage image(const QString &path, const QSize &pixelSize) {
+        QMutexLocker locker(&state().mutex);
+        return state().images.value(imageKey(path, pixelSize));
+    }
+
+private:
+    struct State {
+        QMutex mutex;
+        QHash<QString, QString> styleSheets;
+        QHash<QString, QImage> images;
+    };
+
+    static State &state() {
+        static State s;
+        return s;
+    }
+
+    static QString imageKey(const QString &path, const QSize &pixelSize) {
+        return path + QLatin1Char('@') + QString::number(pixelSize.width()) + QLatin1Char('x') +
+               QString::number(pixelSize.height());
+    }
+};
+
+#endif // STARTUPPRELOADER_H
@@ -0,0 +1,189 @@
+#ifndef STARTUPPROFILER_H
+#define STARTUPPROFILER_H
+
+#include <cstdio>
+#include <functional>
+
+#include <QObject>
+#include <QWidget>
+#include <QLayout>
+#include <QTimer>
+#include <QFile>
+#include <QVector>
+#include <QElapsedTimer>
+#include <QJsonArray>
+#include <QJsonObject>
+#include <QJsonDocument>
+#include <QGuiApplication>
+
+#include "tracer.hpp"
+
+// Startup phase timing for the benchmark in bench/startup/.
+//
+// The benchmark starts the profiler before QApplication, builds the window,
+// watches it and writes the phases as JSON once the first frame and the work
+// queued behind it are done:
+//
+//     QT_QPA_PLATFORM=offscreen ./QWKBench_Startup startup.json
+//
+// The application never starts it, every hook is then a single branch.
+class StartupProfiler {
+public:
+    static void start() {
+        State &s = state();
+        s.enabled = true;
+        s.timer.start();
+    }
+
+    static bool isEnabled() {
+        const State &s = state();
+        return s.enabled && !s.finished;
+    }
+
+    static qint64 now() {
+        return state().timer.nsecsElapsed();
+    }
+
+    static void record(const char *name, qint64 start, qint64 end) {
+        if (!isEnabled())
+            return;
+        state().phases.append({name, start, end});
+    }
+
+    static void recordFirstFrame(qint64 paintStart, qint64 end) {
+        record("first-paint", paintStart, end);
+        if (isEnabled()) {
+            state().firstFrame = end;
+        }
+    }
+
+    // Runs the polish and layout phases explicitly so that they are measured
+    // apart from show(), then calls onFirstFrame once the first frame of the
+    // window has been flushed.
+    static void watch(QWidget *window, std::function<void()> onFirstFrame);
+
+    // Stops recording and writes the results to target, "-" for stdout
+    static bool finish(const QString &target) {
+        State &s = state();
+        if (!isEnabled())
+            return false;
+        s.finished = true;
+
+        QJsonArray phases;
+        for (const Phase &phase : std::as_const(s.phases)) {
+            phases.append(QJsonObject{
+                {QStringLiteral("name"), QString::fromLatin1(phase.name)},
+                {QStringLiteral("start_ms"), phase.start / 1e6},
+                {QStringLiteral("duration_ms"), (phase.end - phase.start) / 1e6},
+            });
+        }
+        const QJsonObject result{
+            {QStringLiteral("version"), 1},
+            {QStringLiteral("qt"), QString::fromLatin1(qVersion())},
+            {QStringLiteral("platform"), QGuiApplication::platformName()},
+            {QStringLiteral("first_frame_ms"), s.firstFrame / 1e6},
+            {QStringLiteral("phases"), phases},
+        };
+        const QByteArray json = QJsonDocument(result).toJson(QJsonDocument::Indented);
+
+        QFile out(target);
+        if (target == QStringLiteral("-") ? out.open(stdout, QIODevice::WriteOnly)
+                                          : out.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+            out.write(json);
+            return true;
+        }
+        qWarning("StartupProfiler: cannot write %s", qPrintable(target));
+        return false;
+    }
+
+private:
+    struct Phase {
+        const char *name;
+        qint64 start;
+        qint64 end;
+    };
+
+    struct State {
+        bool enabled{false};
+        bool finished{false};
+        qint64 firstFrame{-1};
+        QElapsedTimer timer;
+        QVector<Phase> phases;
+    };
+
+    static State &state() {
+        static State s;
+        return s;
+    }
+};
+
+// Records the enclosing scope as a startup phase, and in the trace
+class StartupPhase {
+public:
+    explicit StartupPhase(const char *name)
+        : m_name(name), m_start(StartupProfiler::isEnabled() ? StartupProfiler::now() : -1),
+          m_trace(name, "startup") {
+    }
+
+    ~StartupPhase() {
+        if (m_start >= 0) {
+            StartupProfiler::record(m_name, m_start, StartupProfiler::now());
+        }
+    }
+
+private:
+    const char *m_name;
+    qint64 m_start;
+    TraceScope m_trace;
+};
+
+// Installed after the window has been built, so it sees the first paint
+// before the filters of the window itself and its callback runs before the
+// work they queue for after the first frame.
+class StartupPaintWatcher : public QObject {
+public:
+    StartupPaintWatcher(QWidget *window, std::function<void()> onFirstFrame)
+        : QObject(window), m_onFirstFrame(std::move(onFirstFrame)) {
+        window->installEventFilter(this);
+    }
+
+protected:
+    bool eventFilter(QObject *obj, QEvent *event) override {
+        if (event->type() == QEvent::Paint && m_paintStart < 0) {
+            obj->removeEventFilter(this);
+            // The frame is flushed once the current paint pass has returned
+            m_paintStart = StartupProfiler::now();
+            QTimer::singleShot(0, this, [this]() {
+                StartupProfiler::recordFirstFrame(m_paintStart, StartupProfiler::now());
+                if (m_onFirstFrame) {
+                    m_onFirstFrame();
+                }
+                deleteLater();
+            });
+        }
+        return QObject::eventFilter(obj, event);
+    }
+
+private:
+    std::function<void()> m_onFirstFrame;
+    qint64 m_paintStart{-1};
+};
+
+inline void StartupProfiler::watch(QWidget *window, std::function<void()> onFirstFrame) {
+    if (!isEnabled())
+        return;
+
+    {
+        StartupPhase phase("polish");
+        window->ensurePolished();
+    }
+    {
+        StartupPhase phase("first-layout");
+        if (auto layout = window->layout()) {
+            layout->activate();
+        }
+    }
+    new StartupPaintWatcher(window, std::move(onFirstFrame));
+}
+
+#endif // STARTUPPROFILER_H
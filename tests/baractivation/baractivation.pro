@@ -0,0 +1,6 @@
+TARGET = tst_baractivation
+
+include(../tests.pri)
+
+SOURCES += \
+    tst_baractivation.cpp
@@ -0,0 +1,96 @@
+#include "qwktest.h"
+#include "framelesswindow.h"
+
+// Counts the paint events of a widget
+class PaintCounter : public QObject {
+public:
+    explicit PaintCounter(QWidget *widget) : QObject(widget) {
+        widget->installEventFilter(this);
+    }
+
+    int paints{0};
+
+protected:
+    bool eventFilter(QObject *obj, QEvent *event) override {
+        if (event->type() == QEvent::Paint) {
+            ++paints;
+        }
+        return QObject::eventFilter(obj, event);
+    }
+};
+
+class tst_BarActivation : public QObject {
+    Q_OBJECT
+
+private Q_SLOTS:
+    void initTestCase();
+    void init();
+
+    void flipRepaintsWithoutPolish();
+    void sameColorsSkipRepaint();
+
+private:
+    static void activate(QWidget *window, bool active) {
+        QEvent event(active ? QEvent::WindowActivate : QEvent::WindowDeactivate);
+        QCoreApplication::sendEvent(window, &event);
+    }
+
+    PolishCountingStyle *m_style{nullptr};
+};
+
+void tst_BarActivation::initTestCase() {
+    m_style = new PolishCountingStyle();
+    QApplication::setStyle(m_style);
+}
+
+void tst_BarActivation::init() {
+    ThemeRegistry::instance()->setTheme(Dark);
+}
+
+void tst_BarActivation::flipRepaintsWithoutPolish() {
+    FramelessWindow window;
+    window.show();
+    QVERIFY(QTest::qWaitForWindowExposed(&window));
+    QWidget *bar = window.menuWidget();
+    QVERIFY(bar);
+
+    auto counter = new PaintCounter(bar);
+    activate(&window, true);
+    QTest::qWait(50);
+    m_style->reset();
+    counter->paints = 0;
+
+    for (int i = 0; i < 10; ++i) {
+        activate(&window, i % 2 != 0);
+        QCOMPARE(bar->property("bar-active").toBool(), i % 2 != 0);
+    }
+    QTRY_VERIFY(counter->paints > 0);
+    QCOMPARE(m_style->polishes(), 0);
+}
+
+void tst_BarActivation::sameColorsSkipRepaint() {
+    const ThemePalette &light = ThemePalette::forTheme(Light);
+    if (light.barActive != light.barInactive)
+        QSKIP("the light theme has distinct active and inactive bar colors");
+
+    ThemeRegistry::instance()->setTheme(Light);
+    FramelessWindow window;
+    window.show();
+    QVERIFY(QTest::qWaitForWindowExposed(&window));
+    QWidget *bar = window.menuWidget();
+
+    activate(&window, true);
+    QTest::qWait(50);
+    auto counter = new PaintCounter(bar);
+    m_style->reset();
+
+    activate(&window, false);
+    activate(&window, true);
+    QTest::qWait(50);
+    QCOMPARE(counter->paints, 0);
+    QCOMPARE(m_style->polishes(), 0);
+}
+
+QWK_TEST_MAIN(tst_BarActivation)
+
+#include "tst_baractivation.moc"
@@ -0,0 +1,6 @@
+TARGET = tst_framelessdialog
+
+include(../tests.pri)
+
+SOURCES += \
+    tst_framelessdialog.cpp
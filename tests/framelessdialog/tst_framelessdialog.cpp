@@ -0,0 +1,135 @@
+#include <QtCore/QElapsedTimer>
+#include <QtCore/QThread>
+#include <QtCore/QTimer>
+#include <QtWidgets/QLabel>
+
+#include "qwktest.h"
+#include "FramelessDialog.h"
+#include "framelessdialogpool.hpp"
+
+class tst_FramelessDialog : public QObject {
+    Q_OBJECT
+
+private Q_SLOTS:
+    void openAsyncReturnsWhileOpen();
+    void openAsyncKeepsParentTimers();
+    void openAsyncFinishesOnce();
+    void poolReleasesAfterFinish();
+    void poolRefillsAfterFirstPaint();
+};
+
+void tst_FramelessDialog::openAsyncReturnsWhileOpen() {
+    QWidget parent;
+    parent.show();
+    QVERIFY(QTest::qWaitForWindowExposed(&parent));
+
+    auto dialog = new FramelessDialog(&parent);
+    int result = -1;
+    dialog->openAsync([&result](int r) { result = r; });
+
+    // Still open here, exec() would only return after the dialog is closed
+    QVERIFY(dialog->isVisible());
+    QVERIFY(dialog->isModal());
+    QCOMPARE(result, -1);
+
+    dialog->accept();
+    QCOMPARE(result, int(QDialog::Accepted));
+    delete dialog;
+}
+
+void tst_FramelessDialog::openAsyncKeepsParentTimers() {
+    QWidget parent;
+    parent.show();
+    QVERIFY(QTest::qWaitForWindowExposed(&parent));
+
+    // Runs from the event loop of the test, not from one nested by the dialog
+    const int baseLevel = QThread::currentThread()->loopLevel();
+    int ticks = 0;
+    int maxLevel = baseLevel;
+    qint64 maxGapMs = 0;
+    QElapsedTimer sinceTick;
+    QTimer timer(&parent);
+    timer.setInterval(10);
+    connect(&timer, &QTimer::timeout, &parent, [&]() {
+        if (ticks > 0) {
+            maxGapMs = qMax(maxGapMs, sinceTick.elapsed());
+        }
+        sinceTick.restart();
+        ++ticks;
+        maxLevel = qMax(maxLevel, QThread::currentThread()->loopLevel());
+    });
+    timer.start();
+
+    auto dialog = new FramelessDialog(&parent);
+    dialog->openAsync({});
+    QTest::qWait(300);
+    dialog->reject();
+    delete dialog;
+
+    QCOMPARE(maxLevel, baseLevel);
+    QVERIFY2(ticks >= 10, qPrintable(QStringLiteral("%1 ticks").arg(ticks)));
+    QVERIFY2(maxGapMs < 100, qPrintable(QStringLiteral("gap of %1 ms").arg(maxGapMs)));
+}
+
+void tst_FramelessDialog::openAsyncFinishesOnce() {
+    QWidget parent;
+    auto dialog = new FramelessDialog(&parent);
+
+    int first = 0;
+    int second = 0;
+    dialog->openAsync([&first](int) { ++first; });
+    dialog->reject();
+    dialog->openAsync([&second](int) { ++second; });
+    dialog->accept();
+
+    QCOMPARE(first, 1);
+    QCOMPARE(second, 1);
+    delete dialog;
+}
+
+void tst_FramelessDialog::poolReleasesAfterFinish() {
+    QWidget parent;
+    FramelessDialogPool pool(&parent);
+
+    FramelessDialog *dialog = pool.acquire();
+    QPointer<QLabel> content = new QLabel(QStringLiteral("content"));
+    dialog->setCentralWidget(content);
+
+    int result = -1;
+    pool.open(dialog, [&result, &content](int r) {
+        // The content is still there when the callback runs
+        QVERIFY(content);
+        result = r;
+    });
+    dialog->accept();
+
+    QCOMPARE(result, int(QDialog::Accepted));
+    QVERIFY(!dialog->isVisible());
+    QVERIFY(!dialog->centralWidget());
+    QTRY_VERIFY(!content);
+    QCOMPARE(pool.acquire(), dialog);
+    delete dialog;
+}
+
+void tst_FramelessDialog::poolRefillsAfterFirstPaint() {
+    QWidget parent;
+    parent.show();
+    QVERIFY(QTest::qWaitForWindowExposed(&parent));
+    FramelessDialogPool pool(&parent);
+    QTRY_COMPARE(pool.available(), 1);
+
+    // Nothing is built while the acquired dialog is not on screen yet
+    FramelessDialog *dialog = pool.acquire();
+    QCOMPARE(pool.available(), 0);
+    QCoreApplication::processEvents();
+    QCOMPARE(pool.available(), 0);
+
+    pool.open(dialog);
+    QVERIFY(QTest::qWaitForWindowExposed(dialog));
+    QTRY_COMPARE(pool.available(), 1);
+    dialog->reject();
+}
+
+QWK_TEST_MAIN(tst_FramelessDialog)
+
+#include "tst_framelessdialog.moc"
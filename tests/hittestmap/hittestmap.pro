@@ -0,0 +1,6 @@
+TARGET = tst_hittestmap
+
+include(../tests.pri)
+
+SOURCES += \
+    tst_hittestmap.cpp
@@ -0,0 +1,127 @@
+#include <QtWidgets/QBoxLayout>
+#include <QtWidgets/QToolButton>
+#include <QtWidgets/QVBoxLayout>
+
+#include "qwktest.h"
+#include "framelesshelper.hpp"
+
+class tst_HitTestMap : public QObject {
+    Q_OBJECT
+
+private Q_SLOTS:
+    void init();
+    void cleanup();
+
+    void childrenFillingParentRegisterParent();
+    void disabledChildSplitsParent();
+    void hiddenWidgetIsNotRegistered();
+    void agentAgreesWithMap();
+
+private:
+    // Whether the agent and the map see the same draggable area along the
+    // title bar
+    bool agentAgreesAcrossBar() {
+        QWK::AbstractWindowContext *context = windowContext(m_agent);
+        const QWidget *bar = m_helper->titleBar();
+        const int y = bar->mapTo(m_host, QPoint(0, bar->height() / 2)).y();
+        for (int x = 0; x < m_host->width(); ++x) {
+            const QPoint pos(x, y);
+            const bool draggable = m_helper->hitTest(pos).area == HitTestMap::Caption;
+            if (context->isInTitleBarDraggableArea(pos) != draggable) {
+                qWarning("agent and map differ at %d,%d", x, y);
+                return false;
+            }
+        }
+        return true;
+    }
+
+    QWidget *m_host{nullptr};
+    FramelessHelper *m_helper{nullptr};
+    QWK::WidgetWindowAgent *m_agent{nullptr};
+    QWidget *m_tools{nullptr};
+    QList<QToolButton *> m_buttons;
+};
+
+void tst_HitTestMap::init() {
+    m_host = new QWidget();
+    m_helper = new FramelessHelper(m_host, Dark);
+    m_agent = m_host->findChild<QWK::WidgetWindowAgent *>();
+    QVERIFY(m_agent);
+
+    // Five buttons side by side, filling their container
+    m_tools = new QWidget();
+    auto tools = new QHBoxLayout(m_tools);
+    tools->setContentsMargins(0, 0, 0, 0);
+    tools->setSpacing(0);
+    m_buttons.clear();
+    for (int i = 0; i < 5; ++i) {
+        auto button = new QToolButton();
+        button->setFixedSize(24, 24);
+        tools->addWidget(button);
+        m_buttons.append(button);
+    }
+    auto barLayout = qobject_cast<QBoxLayout *>(m_helper->titleBar()->layout());
+    QVERIFY(barLayout);
+    barLayout->addWidget(m_tools);
+    for (QToolButton *button : std::as_const(m_buttons)) {
+        m_helper->setHitTestVisible(button);
+    }
+
+    auto layout = new QVBoxLayout(m_host);
+    layout->setContentsMargins(0, 0, 0, 0);
+    layout->addWidget(m_helper->titleBar());
+    layout->addStretch();
+    m_host->resize(600, 400);
+    m_host->show();
+    QVERIFY(QTest::qWaitForWindowExposed(m_host));
+    QCoreApplication::processEvents();
+}
+
+void tst_HitTestMap::cleanup() {
+    delete m_host;
+    m_host = nullptr;
+    m_helper = nullptr;
+    m_agent = nullptr;
+}
+
+void tst_HitTestMap::childrenFillingParentRegisterParent() {
+    const HitTestMap::Stats stats = m_helper->hitTestStats();
+    QCOMPARE(stats.requested, 5);
+    QCOMPARE(stats.registered, 1);
+    QVERIFY(m_agent->isHitTestVisible(m_tools));
+    QVERIFY(!m_agent->isHitTestVisible(m_buttons.first()));
+}
+
+void tst_HitTestMap::disabledChildSplitsParent() {
+    m_buttons.at(2)->setEnabled(false);
+    QTRY_COMPARE(m_helper->hitTestStats().registered, 4);
+    QVERIFY(!m_agent->isHitTestVisible(m_tools));
+    QVERIFY(!m_agent->isHitTestVisible(m_buttons.at(2)));
+
+    m_buttons.at(2)->setEnabled(true);
+    QTRY_COMPARE(m_helper->hitTestStats().registered, 1);
+}
+
+void tst_HitTestMap::hiddenWidgetIsNotRegistered() {
+    m_tools->hide();
+    QTRY_COMPARE(m_helper->hitTestStats().registered, 0);
+
+    m_tools->show();
+    QTRY_COMPARE(m_helper->hitTestStats().registered, 1);
+}
+
+void tst_HitTestMap::agentAgreesWithMap() {
+    QVERIFY(agentAgreesAcrossBar());
+
+    m_buttons.at(2)->setEnabled(false);
+    QTRY_COMPARE(m_helper->hitTestStats().registered, 4);
+    QVERIFY(agentAgreesAcrossBar());
+
+    m_host->resize(800, 400);
+    QCoreApplication::processEvents();
+    QVERIFY(agentAgreesAcrossBar());
+}
+
+QWK_TEST_MAIN(tst_HitTestMap)
+
+#include "tst_hittestmap.moc"
@@ -0,0 +1,6 @@
+TARGET = tst_hoverreconciler
+
+include(../tests.pri)
+
+SOURCES += \
+    tst_hoverreconciler.cpp
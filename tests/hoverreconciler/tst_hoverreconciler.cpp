@@ -0,0 +1,109 @@
+#include <QtGui/QCursor>
+#include <QtWidgets/QAbstractButton>
+#include <QtWidgets/QVBoxLayout>
+
+#include "qwktest.h"
+#include "framelesshelper.hpp"
+
+// Counts the Leave events of a widget
+class LeaveCounter : public QObject {
+public:
+    explicit LeaveCounter(QWidget *widget) : QObject(widget) {
+        widget->installEventFilter(this);
+    }
+
+    int leaves{0};
+
+protected:
+    bool eventFilter(QObject *obj, QEvent *event) override {
+        if (event->type() == QEvent::Leave) {
+            ++leaves;
+        }
+        return QObject::eventFilter(obj, event);
+    }
+};
+
+class tst_HoverReconciler : public QObject {
+    Q_OBJECT
+
+private Q_SLOTS:
+    void init();
+    void cleanup();
+
+    void buttonLeftBehindGetsOneLeave();
+    void buttonStillUnderCursorKeepsHover();
+
+private:
+    // Hovers the close button the way a real mouse move does
+    QAbstractButton *hoverCloseButton() {
+        auto button = m_helper->titleBar()->findChild<QAbstractButton *>(QStringLiteral("close-button"));
+        if (!button)
+            return nullptr;
+        QTest::mouseMove(button, button->rect().center());
+        QCoreApplication::processEvents();
+        return button;
+    }
+
+    QWidget *m_host{nullptr};
+    FramelessHelper *m_helper{nullptr};
+};
+
+void tst_HoverReconciler::init() {
+    m_host = new QWidget();
+    m_helper = new FramelessHelper(m_host, Dark);
+    auto layout = new QVBoxLayout(m_host);
+    layout->setContentsMargins(0, 0, 0, 0);
+    layout->addWidget(m_helper->titleBar());
+    layout->addStretch();
+    m_host->resize(600, 400);
+    m_host->move(100, 100);
+    m_host->show();
+    QVERIFY(QTest::qWaitForWindowExposed(m_host));
+}
+
+void tst_HoverReconciler::cleanup() {
+    delete m_host;
+    m_host = nullptr;
+    m_helper = nullptr;
+}
+
+void tst_HoverReconciler::buttonLeftBehindGetsOneLeave() {
+    QAbstractButton *button = hoverCloseButton();
+    QVERIFY(button);
+    QVERIFY(button->underMouse());
+
+    // The window changes under a cursor that does not move: the button is
+    // no longer under it, but no mouse event says so
+    QCursor::setPos(m_host->mapToGlobal(QPoint(m_host->width() / 2, m_host->height() / 2)));
+    QCoreApplication::processEvents();
+    if (!button->underMouse())
+        QSKIP("the platform sent the leave for the cursor move");
+    auto counter = new LeaveCounter(button);
+
+    m_host->resize(700, 450);
+    m_host->move(120, 110);
+    m_host->resize(720, 460);
+    QCOMPARE(counter->leaves, 0);
+
+    // One pass for all of them
+    QTRY_COMPARE(counter->leaves, 1);
+    QTest::qWait(50);
+    QCOMPARE(counter->leaves, 1);
+}
+
+void tst_HoverReconciler::buttonStillUnderCursorKeepsHover() {
+    QAbstractButton *button = hoverCloseButton();
+    QVERIFY(button);
+    QCursor::setPos(button->mapToGlobal(button->rect().center()));
+    QCoreApplication::processEvents();
+    auto counter = new LeaveCounter(button);
+
+    // The close button keeps its place when only the height changes
+    m_host->resize(m_host->width(), m_host->height() + 50);
+    QTest::qWait(50);
+    QCOMPARE(counter->leaves, 0);
+}
+
+QWK_TEST_MAIN(tst_HoverReconciler)
+
+#include "tst_hoverreconciler.moc"
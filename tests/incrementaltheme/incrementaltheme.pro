@@ -0,0 +1,6 @@
+TARGET = tst_incrementaltheme
+
+include(../tests.pri)
+
+SOURCES += \
+    tst_incrementaltheme.cpp
@@ -0,0 +1,121 @@
+#include <QtWidgets/QLabel>
+#include <QtWidgets/QVBoxLayout>
+
+#include "qwktest.h"
+#include "framelesshelper.hpp"
+
+class tst_IncrementalTheme : public QObject {
+    Q_OBJECT
+
+private Q_SLOTS:
+    void initTestCase();
+    void init();
+    void cleanup();
+
+    void switchKeepsTheSheet();
+    void switchRepolishesOnlyDependents();
+    void switchIsFasterThanNewSheet();
+
+private:
+    static QColor token(const ThemeToken *tokens, const char *name) {
+        for (const ThemeToken *token = tokens; token->name; ++token) {
+            if (qstrcmp(token->name, name) == 0)
+                return QColor(QString::fromLatin1(token->value));
+        }
+        return {};
+    }
+
+    PolishCountingStyle *m_style{nullptr};
+    QWidget *m_host{nullptr};
+    FramelessHelper *m_helper{nullptr};
+    QLabel *m_dependent{nullptr};
+    QLabel *m_plain{nullptr};
+};
+
+void tst_IncrementalTheme::initTestCase() {
+    m_style = new PolishCountingStyle();
+    QApplication::setStyle(m_style);
+    if (ThemeRegistry::instance()->incrementalStyleSheet().isEmpty())
+        QSKIP("the theme sheets are not built into the test");
+}
+
+void tst_IncrementalTheme::init() {
+    ThemeRegistry::instance()->setTheme(Dark);
+
+    m_host = new QWidget();
+    m_helper = new FramelessHelper(m_host, Dark, ThemeMode::IncrementalStyleSheet);
+    auto layout = new QVBoxLayout(m_host);
+    layout->addWidget(m_helper->titleBar());
+
+    // QLabel#test takes the content-text token, which differs per theme
+    m_dependent = new QLabel(QStringLiteral("dependent"));
+    m_dependent->setObjectName(QStringLiteral("test"));
+    layout->addWidget(m_dependent);
+    m_plain = new QLabel(QStringLiteral("plain"));
+    layout->addWidget(m_plain);
+    // A large central area the theme rules do not style
+    auto area = new QWidget();
+    addLabels(area, 10000);
+    layout->addWidget(area, 1);
+
+    m_host->show();
+    QVERIFY(QTest::qWaitForWindowExposed(m_host));
+    m_style->reset();
+}
+
+void tst_IncrementalTheme::cleanup() {
+    delete m_host;
+    m_host = nullptr;
+    ThemeRegistry::instance()->setTheme(Dark);
+}
+
+void tst_IncrementalTheme::switchKeepsTheSheet() {
+    const QString sheet = m_host->styleSheet();
+    QCOMPARE(m_dependent->palette().color(QPalette::WindowText), token(ThemeTokens_dark, "content-text"));
+
+    ThemeRegistry::instance()->setTheme(Light);
+
+    QCOMPARE(m_helper->getTheme(), Light);
+    QCOMPARE(m_host->property(ThemeRegistry::themeProperty).toString(), QStringLiteral("light"));
+    // Same sheet, only the theme property changed
+    QCOMPARE(m_host->styleSheet(), sheet);
+    QCOMPARE(m_dependent->palette().color(QPalette::WindowText), token(ThemeTokens_light, "content-text"));
+}
+
+void tst_IncrementalTheme::switchRepolishesOnlyDependents() {
+    const int widgets = m_host->findChildren<QWidget *>().size() + 1;
+
+    ThemeRegistry::instance()->setTheme(Light);
+
+    const ThemeSwitchStats stats = m_helper->lastThemeSwitch();
+    QVERIFY(stats.repolished > 0);
+    QVERIFY2(stats.repolished < widgets,
+             qPrintable(QStringLiteral("%1 of %2 widgets").arg(stats.repolished).arg(widgets)));
+    QVERIFY(m_style->polishes(m_dependent) > 0);
+    QCOMPARE(m_style->polishes(m_plain), 0);
+
+    // And back
+    m_style->reset();
+    ThemeRegistry::instance()->setTheme(Dark);
+    QCOMPARE(m_dependent->palette().color(QPalette::WindowText), token(ThemeTokens_dark, "content-text"));
+    QCOMPARE(m_style->polishes(m_plain), 0);
+}
+
+void tst_IncrementalTheme::switchIsFasterThanNewSheet() {
+    ThemeRegistry::instance()->setTheme(Light);
+    const ThemeSwitchStats incremental = m_helper->lastThemeSwitch();
+
+    // The same switch by replacing the sheet of the host
+    m_helper->setThemeMode(ThemeMode::StyleSheet);
+    ThemeRegistry::instance()->setTheme(Dark);
+    const ThemeSwitchStats full = m_helper->lastThemeSwitch();
+
+    qInfo("incremental: %d widgets repolished in %.2f ms, full sheet: %d in %.2f ms",
+          incremental.repolished, incremental.nsecs / 1e6, full.repolished, full.nsecs / 1e6);
+    QVERIFY(incremental.repolished < full.repolished);
+    QVERIFY(incremental.nsecs < full.nsecs);
+}
+
+QWK_TEST_MAIN(tst_IncrementalTheme)
+
+#include "tst_incrementaltheme.moc"
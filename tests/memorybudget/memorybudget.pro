@@ -0,0 +1,6 @@
+TARGET = tst_memorybudget
+
+include(../tests.pri)
+
+SOURCES += \
+    tst_memorybudget.cpp
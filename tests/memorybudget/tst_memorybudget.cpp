@@ -0,0 +1,81 @@
+#include "qwktest.h"
+#include "FramelessDialog.h"
+#include "framelesswindow.h"
+
+// What a frameless dialog and main window may hold once shown. A change that
+// needs more raises the budget here, on purpose.
+static constexpr const int DialogObjectBudget = 80;
+static constexpr const int WindowObjectBudget = 200;
+// Heap of the frameless parts, see FramelessMemoryReport::heapBytes
+static constexpr const qint64 HeapBudget = 512 * 1024;
+
+class tst_MemoryBudget : public QObject {
+    Q_OBJECT
+
+private Q_SLOTS:
+    void initTestCase();
+
+    void titleBarPartsWaitForShow();
+    void dialogWithinBudget();
+    void windowWithinBudget();
+
+private:
+    static void verifyHeap(const FramelessMemoryReport &report) {
+        if (report.heapBytes < 0) {
+            qInfo("heap accounting not supported here");
+            return;
+        }
+        QVERIFY2(report.heapBytes <= HeapBudget, qPrintable(QString::number(report.heapBytes)));
+    }
+};
+
+void tst_MemoryBudget::initTestCase() {
+    // Read once, by the first helper
+    qputenv("QWK_MEMORY_REPORT", "1");
+    // The shared sheet is loaded once per process, not charged to a window
+    delete new FramelessDialog(nullptr);
+}
+
+void tst_MemoryBudget::titleBarPartsWaitForShow() {
+    FramelessDialog dialog(nullptr);
+    const FramelessMemoryReport hidden = dialog.memoryReport();
+    QCOMPARE(hidden.classes.value(QStringLiteral("QWK::WindowButton")), 0);
+
+    dialog.show();
+    QVERIFY(QTest::qWaitForWindowExposed(&dialog));
+    const FramelessMemoryReport shown = dialog.memoryReport();
+    QVERIFY(shown.classes.value(QStringLiteral("QWK::WindowButton")) > 0);
+}
+
+void tst_MemoryBudget::dialogWithinBudget() {
+    FramelessDialog dialog(nullptr);
+    dialog.setCentralWidget(new QLabel(QStringLiteral("Hello world")));
+    dialog.show();
+    QVERIFY(QTest::qWaitForWindowExposed(&dialog));
+
+    const FramelessMemoryReport report = dialog.memoryReport();
+    qInfo("dialog: %d objects, %d widgets, %lld heap bytes", report.objects, report.widgets,
+          report.heapBytes);
+    QVERIFY2(report.objects <= DialogObjectBudget, qPrintable(QString::number(report.objects)));
+    verifyHeap(report);
+}
+
+void tst_MemoryBudget::windowWithinBudget() {
+    FramelessWindow window(nullptr, QStringLiteral("tst-memorybudget"));
+    window.show();
+    QVERIFY(QTest::qWaitForWindowExposed(&window));
+    QCoreApplication::processEvents();
+
+    const FramelessMemoryReport report = window.memoryReport();
+    qInfo("window: %d objects, %d widgets, %lld heap bytes, %d child windows of %d objects",
+          report.objects, report.widgets, report.heapBytes, report.childWindows,
+          report.childWindowObjects);
+    QVERIFY2(report.objects <= WindowObjectBudget, qPrintable(QString::number(report.objects)));
+    // The menus create their actions when first opened
+    QCOMPARE(report.classes.value(QStringLiteral("QActionGroup")), 0);
+    verifyHeap(report);
+}
+
+QWK_TEST_MAIN(tst_MemoryBudget)
+
+#include "tst_memorybudget.moc"
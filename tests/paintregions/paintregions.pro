@@ -0,0 +1,6 @@
+TARGET = tst_paintregions
+
+include(../tests.pri)
+
+SOURCES += \
+    tst_paintregions.cpp
@@ -0,0 +1,101 @@
+#include <QtWidgets/QLabel>
+#include <QtWidgets/QVBoxLayout>
+
+#include "qwktest.h"
+#include "framelesshelper.hpp"
+
+class tst_PaintRegions : public QObject {
+    Q_OBJECT
+
+private Q_SLOTS:
+    void init();
+    void cleanup();
+
+    void debuggerGroupsFrames();
+    void barFlipStaysInTheBar();
+    void titleRepaintsOnlyTheLabel();
+
+private:
+    // Waits until a paint after the current frame count has been grouped
+    bool waitForFrame(int framesBefore) {
+        return QTest::qWaitFor([&]() { return m_debugger->stats().frames > framesBefore; });
+    }
+
+    QRect windowRect(const QWidget *widget) const {
+        return QRect(widget->mapTo(m_host, QPoint()), widget->size());
+    }
+
+    QWidget *m_host{nullptr};
+    FramelessHelper *m_helper{nullptr};
+    QWidget *m_content{nullptr};
+    PaintDebugger *m_debugger{nullptr};
+};
+
+void tst_PaintRegions::init() {
+    ThemeRegistry::instance()->setTheme(Dark);
+
+    m_host = new QWidget();
+    m_helper = new FramelessHelper(m_host, Dark);
+    auto layout = new QVBoxLayout(m_host);
+    layout->setContentsMargins(0, 0, 0, 0);
+    layout->addWidget(m_helper->titleBar());
+    m_content = new QLabel(QStringLiteral("content"));
+    layout->addWidget(m_content, 1);
+    m_host->resize(600, 400);
+
+    // Without QWK_PAINT_DEBUG, the test reads the frames itself
+    m_debugger = new PaintDebugger(m_host);
+    m_host->show();
+    QVERIFY(QTest::qWaitForWindowExposed(m_host));
+    m_helper->setBarActive(true);
+    QTest::qWait(50);
+}
+
+void tst_PaintRegions::cleanup() {
+    delete m_host;
+    m_host = nullptr;
+}
+
+void tst_PaintRegions::debuggerGroupsFrames() {
+    const int frames = m_debugger->stats().frames;
+    m_content->update(QRect(0, 0, 10, 10));
+    m_content->update(QRect(20, 20, 10, 10));
+    QVERIFY(waitForFrame(frames));
+
+    // Both updates are painted in one pass, which is one frame
+    const PaintDebugger::Frame frame = m_debugger->frames().constLast();
+    QVERIFY(windowRect(m_content).contains(frame.region.boundingRect()));
+    QVERIFY(frame.area <= 2 * 10 * 10);
+}
+
+void tst_PaintRegions::barFlipStaysInTheBar() {
+    const int frames = m_debugger->stats().frames;
+    m_helper->setBarActive(false);
+    QVERIFY(waitForFrame(frames));
+
+    const PaintDebugger::Frame frame = m_debugger->frames().constLast();
+    const QRect bar = windowRect(m_helper->titleBar());
+    QVERIFY(bar.contains(frame.region.boundingRect()));
+    // The opaque bar does not reach the content beneath
+    QVERIFY(!frame.region.intersects(windowRect(m_content)));
+}
+
+void tst_PaintRegions::titleRepaintsOnlyTheLabel() {
+    QLabel *label = m_helper->titleLabel();
+    const QRect labelRect = windowRect(label);
+    const QSize sizeHint = label->sizeHint();
+    const int frames = m_debugger->stats().frames;
+
+    m_host->setWindowTitle(QStringLiteral("A much longer title than the one before it"));
+    QVERIFY(waitForFrame(frames));
+
+    const PaintDebugger::Frame frame = m_debugger->frames().constLast();
+    QVERIFY(labelRect.contains(frame.region.boundingRect()));
+    // No relayout, the label kept its place
+    QCOMPARE(windowRect(label), labelRect);
+    QCOMPARE(label->sizeHint(), sizeHint);
+}
+
+QWK_TEST_MAIN(tst_PaintRegions)
+
+#include "tst_paintregions.moc"
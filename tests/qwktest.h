@@ -0,0 +1,77 @@
+#ifndef QWKTEST_H
+#define QWKTEST_H
+
+#include <QtCore/QHash>
+#include <QtCore/QStandardPaths>
+#include <QtTest/QtTest>
+#include <QtWidgets/QApplication>
+#include <QtWidgets/QGridLayout>
+#include <QtWidgets/QLabel>
+#include <QtWidgets/QProxyStyle>
+#include <QWKCore/private/windowagentbase_p.h>
+
+// Like QTEST_MAIN, on the offscreen platform unless QT_QPA_PLATFORM is set,
+// so the tests run without a display. Saved window states go to the test
+// locations instead of the user's.
+#define QWK_TEST_MAIN(TestObject)                                                                  \
+    int main(int argc, char *argv[]) {                                                             \
+        if (qEnvironmentVariableIsEmpty("QT_QPA_PLATFORM"))                                        \
+            qputenv("QT_QPA_PLATFORM", "offscreen");                                               \
+        QStandardPaths::setTestModeEnabled(true);                                                  \
+        QApplication app(argc, argv);                                                              \
+        TestObject test;                                                                           \
+        return QTest::qExec(&test, argc, argv);                                                    \
+    }
+
+// Fills area with count labels in rows of 50, a stand-in for a large central
+// widget that the theme rules do not style
+inline void addLabels(QWidget *area, int count) {
+    auto layout = new QGridLayout(area);
+    for (int i = 0; i < count; ++i) {
+        layout->addWidget(new QLabel(QString::number(i), area), i / 50, i % 50);
+    }
+}
+
+// The window context of an agent, where QWindowKit tests the title bar on
+// every mouse move. Reached through the protected d_ptr of the agent.
+inline QWK::AbstractWindowContext *windowContext(QWK::WindowAgentBase *agent) {
+    struct Access : QWK::WindowAgentBase {
+        static QWK::AbstractWindowContext *context(QWK::WindowAgentBase *agent) {
+            return (agent->*&Access::d_ptr)->context.get();
+        }
+    };
+    return Access::context(agent);
+}
+
+// Application style counting the polishes per widget. Style sheets polish
+// through the application style as well.
+class PolishCountingStyle : public QProxyStyle {
+public:
+    using QProxyStyle::polish;
+
+    void polish(QWidget *widget) override {
+        ++m_polishes[widget];
+        QProxyStyle::polish(widget);
+    }
+
+    int polishes() const {
+        int total = 0;
+        for (int count : m_polishes) {
+            total += count;
+        }
+        return total;
+    }
+
+    int polishes(const QWidget *widget) const {
+        return m_polishes.value(widget);
+    }
+
+    void reset() {
+        m_polishes.clear();
+    }
+
+private:
+    QHash<const QWidget *, int> m_polishes;
+};
+
+#endif // QWKTEST_H
@@ -0,0 +1,12 @@
+TARGET = tst_screenchange
+
+include(../tests.pri)
+
+SOURCES += \
+    tst_screenchange.cpp
+
+# 离屏平台的双屏配置
+DEFINES += SCREENS_CONFIG=\\\"$$PWD/screens.json\\\"
+
+DISTFILES += \
+    screens.json
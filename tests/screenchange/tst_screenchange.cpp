@@ -0,0 +1,120 @@
+#include <QtGui/QScreen>
+#include <QtWidgets/QAbstractButton>
+#include <QtWidgets/QVBoxLayout>
+
+#include "qwktest.h"
+#include "framelesshelper.hpp"
+
+// Counts the resizes of a widget, each one a layout pass that changed it
+class ResizeCounter : public QObject {
+public:
+    explicit ResizeCounter(QWidget *widget) : QObject(widget) {
+        widget->installEventFilter(this);
+    }
+
+    int resizes{0};
+
+protected:
+    bool eventFilter(QObject *obj, QEvent *event) override {
+        if (event->type() == QEvent::Resize) {
+            ++resizes;
+        }
+        return QObject::eventFilter(obj, event);
+    }
+};
+
+class tst_ScreenChange : public QObject {
+    Q_OBJECT
+
+private Q_SLOTS:
+    void init();
+    void cleanup();
+
+    void crossingsRelayoutOnce();
+    void resizeSettlesRightAway();
+
+private:
+    // One border crossing: the new screen, the metrics of the bar children
+    // changing with it, and the move that goes with it. With two screens the
+    // platform sends the screen change itself.
+    void cross(int step) {
+        const QList<QScreen *> screens = QGuiApplication::screens();
+        if (screens.size() > 1) {
+            QScreen *screen = screens.at(step % 2 == 0 ? 1 : 0);
+            m_host->move(screen->geometry().topLeft() + QPoint(100, 100));
+        } else {
+            QEvent screenChange(QEvent::ScreenChangeInternal);
+            QCoreApplication::sendEvent(m_host, &screenChange);
+            m_host->move(m_host->pos() + QPoint(10, 0));
+        }
+        m_iconButton->setIconSize(QSize(18 + 2 * step, 18 + 2 * step));
+    }
+
+    QWidget *m_host{nullptr};
+    FramelessHelper *m_helper{nullptr};
+    QAbstractButton *m_iconButton{nullptr};
+};
+
+void tst_ScreenChange::init() {
+    m_host = new QWidget();
+    m_helper = new FramelessHelper(m_host, Dark);
+    auto layout = new QVBoxLayout(m_host);
+    layout->setContentsMargins(0, 0, 0, 0);
+    layout->addWidget(m_helper->titleBar());
+    layout->addStretch();
+    m_host->resize(600, 400);
+    m_host->move(QGuiApplication::primaryScreen()->geometry().topLeft() + QPoint(100, 100));
+    m_host->show();
+    QVERIFY(QTest::qWaitForWindowExposed(m_host));
+
+    m_iconButton = m_helper->titleBar()->findChild<QAbstractButton *>(QStringLiteral("icon-button"));
+    QVERIFY(m_iconButton);
+    QTest::qWait(50);
+}
+
+void tst_ScreenChange::cleanup() {
+    delete m_host;
+    m_host = nullptr;
+}
+
+void tst_ScreenChange::crossingsRelayoutOnce() {
+    auto counter = new ResizeCounter(m_iconButton);
+    const ScreenChangeCoalescer::Stats before = m_helper->screenChangeStats();
+
+    static constexpr const int crossings = 5;
+    for (int step = 0; step < crossings; ++step) {
+        cross(step);
+        // Well within the settle delay, layout requests are handled
+        QTest::qWait(10);
+    }
+    QCOMPARE(counter->resizes, 0);
+
+    QTRY_COMPARE(m_helper->screenChangeStats().settles - before.settles, 1);
+    QCOMPARE(counter->resizes, 1);
+    QVERIFY(m_helper->screenChangeStats().notifications - before.notifications >= crossings);
+    QCOMPARE(m_iconButton->width(), m_iconButton->sizeHint().width());
+}
+
+void tst_ScreenChange::resizeSettlesRightAway() {
+    const ScreenChangeCoalescer::Stats before = m_helper->screenChangeStats();
+    cross(0);
+    QCoreApplication::processEvents();
+
+    m_host->resize(m_host->width() + 40, m_host->height());
+    QTRY_COMPARE(m_helper->screenChangeStats().settles - before.settles, 1);
+    QTest::qWait(200);
+    QCOMPARE(m_helper->screenChangeStats().settles - before.settles, 1);
+}
+
+// Two screens with different ratios where the offscreen platform takes a
+// screen configuration, one screen and synthetic screen changes otherwise
+int main(int argc, char *argv[]) {
+    if (qEnvironmentVariableIsEmpty("QT_QPA_PLATFORM"))
+        qputenv("QT_QPA_PLATFORM", QByteArrayLiteral("offscreen:configfile=") + SCREENS_CONFIG);
+    QStandardPaths::setTestModeEnabled(true);
+    QApplication app(argc, argv);
+    tst_ScreenChange test;
+    return QTest::qExec(&test, argc, argv);
+}
+
+#include "tst_screenchange.moc"
@@ -0,0 +1,16 @@
+# 各测试共用的配置
+
+QT       += core gui widgets testlib
+
+TEMPLATE = app
+
+CONFIG += c++17 console testcase
+CONFIG -= app_bundle
+
+# 窗口与辅助类
+include($$PWD/../framelesswindow.pri)
+
+HEADERS += \
+    $$PWD/qwktest.h
+
+INCLUDEPATH += $$PWD
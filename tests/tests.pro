@@ -0,0 +1,18 @@
+#-------------------------------------------------#
+# 行为测试：QtTest，离屏平台运行（make check）    #
+#-------------------------------------------------#
+
+TEMPLATE = subdirs
+
+SUBDIRS += \
+    baractivation \
+    framelessdialog \
+    hittestmap \
+    hoverreconciler \
+    incrementaltheme \
+    memorybudget \
+    paintregions \
+    screenchange \
+    updatechannel \
+    windowstate \
+    windowupdate
@@ -0,0 +1,138 @@
+#include <atomic>
+#include <memory>
+#include <vector>
+
+#include <QtCore/QThread>
+
+#include "qwktest.h"
+#include "updatechannel.hpp"
+
+class tst_UpdateChannel : public QObject {
+    Q_OBJECT
+
+private Q_SLOTS:
+    void latestValuePerKey();
+    void fullRingKeepsLatestValue();
+    void producersStress_data();
+    void producersStress();
+};
+
+void tst_UpdateChannel::latestValuePerKey() {
+    UpdateChannel channel;
+    QVector<int> delivered;
+    channel.bind(QStringLiteral("progress"),
+                 [&delivered](const QVariant &value) { delivered.append(value.toInt()); });
+
+    for (int i = 0; i < 100; ++i) {
+        channel.post(QStringLiteral("progress"), i);
+    }
+    channel.drain();
+
+    QCOMPARE(delivered, QVector<int>{99});
+    const UpdateChannel::Stats stats = channel.stats();
+    QCOMPARE(stats.posted, qint64(100));
+    QCOMPARE(stats.coalesced, qint64(99));
+    QCOMPARE(stats.delivered, qint64(1));
+    QCOMPARE(stats.drains, 1);
+}
+
+void tst_UpdateChannel::fullRingKeepsLatestValue() {
+    UpdateChannel channel(nullptr, 4);
+    QHash<QString, QVariant> delivered;
+    for (const QString &key : {QStringLiteral("progress"), QStringLiteral("title")}) {
+        channel.bind(key,
+                     [&delivered, key](const QVariant &value) { delivered.insert(key, value); });
+    }
+
+    // The ring fills up with progress, the final title and progress overflow
+    for (int i = 0; i < 10; ++i) {
+        channel.post(QStringLiteral("progress"), i);
+    }
+    channel.post(QStringLiteral("title"), QStringLiteral("done"));
+    channel.post(QStringLiteral("progress"), 10);
+    channel.drain();
+
+    QCOMPARE(delivered.value(QStringLiteral("title")).toString(), QStringLiteral("done"));
+    QCOMPARE(delivered.value(QStringLiteral("progress")).toInt(), 10);
+    const UpdateChannel::Stats stats = channel.stats();
+    QCOMPARE(stats.posted, qint64(12));
+    QCOMPARE(stats.overflowed, qint64(8));
+    QCOMPARE(stats.delivered, qint64(2));
+    QCOMPARE(stats.coalesced, qint64(10));
+    QCOMPARE(stats.maxDepth, 4);
+
+    // The ring is usable again
+    channel.post(QStringLiteral("progress"), 11);
+    channel.drain();
+    QCOMPARE(delivered.value(QStringLiteral("progress")).toInt(), 11);
+    QCOMPARE(channel.stats().overflowed, qint64(8));
+}
+
+void tst_UpdateChannel::producersStress_data() {
+    QTest::addColumn<int>("producers");
+    QTest::addColumn<int>("capacity");
+
+    QTest::newRow("8 producers") << 8 << 1024;
+    // A ring much smaller than a burst, most posts overflow
+    QTest::newRow("8 producers, small ring") << 8 << 16;
+}
+
+void tst_UpdateChannel::producersStress() {
+    QFETCH(int, producers);
+    QFETCH(int, capacity);
+    static constexpr const int updates = 20000;
+
+    UpdateChannel channel(nullptr, capacity);
+    channel.setFrameInterval(1);
+
+    // Per key: the last value seen and whether it ever went backwards
+    QVector<int> last(producers, -1);
+    bool ordered = true;
+    bool onGuiThread = true;
+    for (int p = 0; p < producers; ++p) {
+        channel.bind(QString::number(p), [&, p](const QVariant &value) {
+            onGuiThread = onGuiThread && QThread::currentThread() == qApp->thread();
+            ordered = ordered && value.toInt() > last[p];
+            last[p] = value.toInt();
+        });
+    }
+
+    std::atomic<int> running{producers};
+    std::vector<std::unique_ptr<QThread>> threads;
+    for (int p = 0; p < producers; ++p) {
+        threads.emplace_back(QThread::create([&channel, &running, p]() {
+            const QString key = QString::number(p);
+            for (int i = 0; i < updates; ++i) {
+                channel.post(key, i);
+            }
+            running.fetch_sub(1);
+        }));
+        threads.back()->start();
+    }
+
+    // The GUI thread keeps draining while the producers run
+    QTRY_VERIFY_WITH_TIMEOUT(running.load() == 0, 30000);
+    for (auto &thread : threads) {
+        QVERIFY(thread->wait(5000));
+    }
+    channel.drain();
+
+    QVERIFY(onGuiThread);
+    QVERIFY(ordered);
+    for (int p = 0; p < producers; ++p) {
+        QCOMPARE(last[p], updates - 1);
+    }
+
+    // Every update is replaced by a newer one or delivered, none is lost
+    const UpdateChannel::Stats stats = channel.stats();
+    QCOMPARE(stats.posted, qint64(producers) * updates);
+    QCOMPARE(stats.posted, stats.coalesced + stats.delivered);
+    QVERIFY(stats.maxDepth <= capacity);
+    // Far fewer wake-ups and deliveries than posts
+    QVERIFY(stats.drains < stats.posted / 10);
+    QVERIFY(stats.delivered <= qint64(stats.drains) * producers);
+}
+
+QWK_TEST_MAIN(tst_UpdateChannel)
+
+#include "tst_updatechannel.moc"
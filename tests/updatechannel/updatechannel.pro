@@ -0,0 +1,6 @@
+TARGET = tst_updatechannel
+
+include(../tests.pri)
+
+SOURCES += \
+    tst_updatechannel.cpp
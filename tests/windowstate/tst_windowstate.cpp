@@ -0,0 +1,115 @@
+#include "qwktest.h"
+#include "framelesswindow.h"
+#include "windowstate.hpp"
+
+// Counts the layout requests and resizes a widget receives
+class LayoutCounter : public QObject {
+public:
+    explicit LayoutCounter(QWidget *widget) : QObject(widget) {
+        widget->installEventFilter(this);
+    }
+
+    int layouts{0};
+    int resizes{0};
+    QSize firstSize;
+
+protected:
+    bool eventFilter(QObject *obj, QEvent *event) override {
+        if (event->type() == QEvent::LayoutRequest) {
+            ++layouts;
+        } else if (event->type() == QEvent::Resize) {
+            if (resizes++ == 0) {
+                firstSize = static_cast<QResizeEvent *>(event)->size();
+            }
+        }
+        return QObject::eventFilter(obj, event);
+    }
+};
+
+class tst_WindowState : public QObject {
+    Q_OBJECT
+
+private Q_SLOTS:
+    void initTestCase();
+    void init();
+
+    void saveAndLoad();
+    void restoreBeforeShowLaysOutOnce();
+    void restoreAfterShowIsCounted();
+
+private:
+    static WindowState savedState() {
+        WindowState state;
+        state.geometry = QRect(40, 40, 640, 420);
+        state.theme = Light;
+        state.themeMode = ThemeMode::StyleSheet;
+        return state;
+    }
+
+    PolishCountingStyle *m_style{nullptr};
+};
+
+void tst_WindowState::initTestCase() {
+    m_style = new PolishCountingStyle();
+    QApplication::setStyle(m_style);
+}
+
+void tst_WindowState::init() {
+    // The main window saves its state on close, start each case from scratch
+    QVERIFY(WindowState{}.save(QStringLiteral("tst-windowstate")));
+    ThemeRegistry::instance()->setTheme(Dark);
+    m_style->reset();
+}
+
+void tst_WindowState::saveAndLoad() {
+    WindowState state = savedState();
+    state.maximized = true;
+    state.themeMode = ThemeMode::Native;
+    state.windowStyle = QStringLiteral("mica");
+    QVERIFY(state.save(QStringLiteral("tst-windowstate")));
+
+    const WindowState loaded = WindowState::load(QStringLiteral("tst-windowstate"));
+    QCOMPARE(loaded.geometry, state.geometry);
+    QCOMPARE(loaded.maximized, true);
+    QCOMPARE(loaded.theme, Light);
+    QCOMPARE(int(loaded.themeMode), int(ThemeMode::Native));
+    QCOMPARE(loaded.windowStyle, QStringLiteral("mica"));
+}
+
+void tst_WindowState::restoreBeforeShowLaysOutOnce() {
+    const WindowState state = savedState();
+    QVERIFY(state.save(QStringLiteral("tst-windowstate")));
+
+    FramelessWindow window(nullptr, QStringLiteral("tst-windowstate"));
+    auto counter = new LayoutCounter(&window);
+    window.show();
+    QVERIFY(QTest::qWaitForWindowExposed(&window));
+    QCoreApplication::processEvents();
+
+    qInfo("%d layout requests, %d resizes, %d polishes of the window", counter->layouts,
+          counter->resizes, m_style->polishes(&window));
+    QCOMPARE(ThemeRegistry::instance()->theme(), Light);
+    QCOMPARE(m_style->polishes(&window), 1);
+    // Shown at the saved size right away, no jump from a default size
+    QCOMPARE(counter->resizes, 1);
+    QCOMPARE(counter->firstSize, state.geometry.size());
+    QVERIFY(counter->layouts <= 1);
+}
+
+void tst_WindowState::restoreAfterShowIsCounted() {
+    // The window comes up at its default size and is corrected afterwards,
+    // as before the state was restored ahead of show()
+    FramelessWindow window(nullptr, QStringLiteral("tst-windowstate"));
+    auto counter = new LayoutCounter(&window);
+    window.show();
+    QVERIFY(QTest::qWaitForWindowExposed(&window));
+    window.setGeometry(savedState().geometry);
+    QCoreApplication::processEvents();
+
+    QVERIFY(counter->resizes >= 2);
+    QVERIFY(counter->firstSize != savedState().geometry.size());
+}
+
+QWK_TEST_MAIN(tst_WindowState)
+
+#include "tst_windowstate.moc"
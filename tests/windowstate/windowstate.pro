@@ -0,0 +1,6 @@
+TARGET = tst_windowstate
+
+include(../tests.pri)
+
+SOURCES += \
+    tst_windowstate.cpp
@@ -0,0 +1,130 @@
+#include <memory>
+
+#include <QtCore/QSet>
+#include <QtCore/QVector>
+
+#include "qwktest.h"
+#include "framelesshelper.hpp"
+
+// Records what would have reached the window agent, rejects the given keys
+class RecordingSink : public WindowAttributeSink {
+public:
+    struct Call {
+        QString key;
+        QVariant value;
+    };
+
+    RecordingSink(QVector<Call> *calls, QSet<QString> rejected = {})
+        : m_calls(calls), m_rejected(std::move(rejected)) {
+    }
+
+    bool setWindowAttribute(const QString &key, const QVariant &value) override {
+        m_calls->append({key, value});
+        return !m_rejected.contains(key);
+    }
+
+private:
+    QVector<Call> *m_calls;
+    QSet<QString> m_rejected;
+};
+
+class tst_WindowUpdate : public QObject {
+    Q_OBJECT
+
+private Q_SLOTS:
+    void init();
+    void cleanup();
+
+    void explicitFalseReachesAgent();
+    void acceptedValueIsNotResent();
+    void rejectedValueIsNotRecorded();
+    void commitClearsFirstAndPolishesOnce();
+
+private:
+    void useSink(QSet<QString> rejected = {}) {
+        m_helper->setWindowAttributeSink(std::make_unique<RecordingSink>(&m_calls, std::move(rejected)));
+    }
+
+    QWidget *m_host{nullptr};
+    FramelessHelper *m_helper{nullptr};
+    QVector<RecordingSink::Call> m_calls;
+};
+
+void tst_WindowUpdate::init() {
+    m_host = new QWidget();
+    m_helper = new FramelessHelper(m_host, Dark);
+    m_calls.clear();
+}
+
+void tst_WindowUpdate::cleanup() {
+    delete m_host;
+    m_host = nullptr;
+    m_helper = nullptr;
+}
+
+void tst_WindowUpdate::explicitFalseReachesAgent() {
+    useSink();
+
+    // Never set before, the platform default may still be on
+    QVERIFY(m_helper->setWindowAttribute(QStringLiteral("no-system-buttons"), false));
+
+    QCOMPARE(m_calls.size(), 1);
+    QCOMPARE(m_calls.at(0).key, QStringLiteral("no-system-buttons"));
+    QCOMPARE(m_calls.at(0).value, QVariant(false));
+}
+
+void tst_WindowUpdate::acceptedValueIsNotResent() {
+    useSink();
+
+    QVERIFY(m_helper->setWindowAttribute(QStringLiteral("mica"), true));
+    QVERIFY(m_helper->setWindowAttribute(QStringLiteral("mica"), true));
+    QCOMPARE(m_calls.size(), 1);
+
+    QVERIFY(m_helper->setWindowAttribute(QStringLiteral("mica"), false));
+    QCOMPARE(m_calls.size(), 2);
+    QCOMPARE(m_helper->windowUpdateStats().nativeCalls, 2);
+}
+
+void tst_WindowUpdate::rejectedValueIsNotRecorded() {
+    useSink({QStringLiteral("mica")});
+
+    QVERIFY(!m_helper->setWindowAttribute(QStringLiteral("mica"), true));
+    // Not taken as applied, the next request is sent again
+    QVERIFY(!m_helper->setWindowAttribute(QStringLiteral("mica"), true));
+    QCOMPARE(m_calls.size(), 2);
+
+    m_helper->beginWindowUpdate();
+    m_helper->setWindowAttribute(QStringLiteral("mica"), true);
+    m_helper->setWindowAttribute(QStringLiteral("dwm-blur"), true);
+    QVERIFY(!m_helper->commitWindowUpdate());
+}
+
+void tst_WindowUpdate::commitClearsFirstAndPolishesOnce() {
+    useSink();
+    const FramelessHelper::WindowUpdateStats before = m_helper->windowUpdateStats();
+
+    m_helper->beginWindowUpdate();
+    m_helper->setWindowAttribute(QStringLiteral("mica"), false);
+    m_helper->setWindowAttribute(QStringLiteral("acrylic-material"), true);
+    m_helper->setWindowAttribute(QStringLiteral("dwm-blur"), false);
+    m_helper->setWindowProperty("custom-style", true);
+    m_helper->setWindowProperty("custom-style", false);
+    m_helper->setWindowProperty("custom-style", true);
+    QVERIFY(m_calls.isEmpty());
+    QVERIFY(m_helper->commitWindowUpdate());
+
+    QCOMPARE(m_calls.size(), 3);
+    QCOMPARE(m_calls.at(0).key, QStringLiteral("mica"));
+    QCOMPARE(m_calls.at(1).key, QStringLiteral("dwm-blur"));
+    QCOMPARE(m_calls.at(2).key, QStringLiteral("acrylic-material"));
+    QCOMPARE(m_calls.at(2).value, QVariant(true));
+
+    const FramelessHelper::WindowUpdateStats after = m_helper->windowUpdateStats();
+    QCOMPARE(after.commits - before.commits, 1);
+    QCOMPARE(after.polishes - before.polishes, 1);
+    QCOMPARE(m_host->property("custom-style"), QVariant(true));
+}
+
+QWK_TEST_MAIN(tst_WindowUpdate)
+
+#include "tst_windowupdate.moc"
@@ -0,0 +1,6 @@
+TARGET = tst_windowupdate
+
+include(../tests.pri)
+
+SOURCES += \
+    tst_windowupdate.cpp
@@ -0,0 +1,160 @@
+#ifndef THEMEDIFF_H
+#define THEMEDIFF_H
+
+#include <QWidget>
+#include <QHash>
+#include <QVector>
+#include <QString>
+#include <QStringList>
+#include <QRegularExpression>
+
+// Subject of a qss selector: the class and object name of the widget it
+// styles, without pseudo states, sub-controls and attributes.
+struct ThemeSelector {
+    QByteArray className;
+    QString objectName;
+
+    bool matches(const QWidget *widget) const {
+        if (!objectName.isEmpty() && widget->objectName() != objectName) {
+            return false;
+        }
+        return className.isEmpty() || className == "*" || widget->inherits(className.constData());
+    }
+
+    bool operator==(const ThemeSelector &other) const {
+        return className == other.className && objectName == other.objectName;
+    }
+};
+
+// What the last theme switch of a FramelessHelper cost
+struct ThemeSwitchStats {
+    int repolished{0};
+    qint64 nsecs{0};
+};
+
+// A style sheet split into rules, one entry per selector of a rule group.
+//
+// Two themes compiled from the same template only differ in declarations, so
+// comparing them selector by selector tells which widgets have to be
+// repolished when switching. qualified() scopes every rule to hosts that carry
+// a given property, which lets both themes live in one sheet that never
+// changes after it is set.
+class ThemeRuleSet {
+public:
+    explicit ThemeRuleSet(const QString &sheet) {
+        static const QRegularExpression comments(QStringLiteral("/\\*.*?\\*/"),
+                                                 QRegularExpression::DotMatchesEverythingOption);
+        static const QRegularExpression child(QStringLiteral("\\s*>\\s*"));
+
+        QString source = sheet;
+        source.remove(comments);
+
+        int pos = 0;
+        while (true) {
+            const int open = source.indexOf(QLatin1Char('{'), pos);
+            const int close = open < 0 ? -1 : source.indexOf(QLatin1Char('}'), open);
+            if (close < 0) {
+                break;
+            }
+            const QString body = source.mid(open + 1, close - open - 1).simplified();
+            const QStringList selectors = source.mid(pos, open - pos).split(QLatin1Char(','));
+            for (const QString &selector : selectors) {
+                QString normalized = selector.simplified();
+                normalized.replace(child, QStringLiteral(">"));
+                if (!normalized.isEmpty()) {
+                    m_rules.append({normalized, body});
+                }
+            }
+            pos = close + 1;
+        }
+    }
+
+    bool isEmpty() const {
+        return m_rules.isEmpty();
+    }
+
+    // The rules restricted to widgets that have an ancestor, or are
+    // themselves a selector root, matching attribute, e.g.
+    // [frameless-theme="dark"]. Every rule gains the same specificity, so the
+    // cascade within one theme is unchanged.
+    QString qualified(const QString &attribute) const {
+        const QString scope = QLatin1Char('*') + attribute + QLatin1Char(' ');
+        QString result;
+        for (const Rule &rule : m_rules) {
+            result += scope + rule.selector;
+            if (!rule.selector.contains(QLatin1Char('>')) && !rule.selector.contains(QLatin1Char(' '))) {
+                int pseudo = rule.selector.indexOf(QLatin1Char(':'));
+                if (pseudo < 0) {
+                    pseudo = rule.selector.size();
+                }
+                result += QLatin1Char(',');
+                result += rule.selector.left(pseudo) + attribute + rule.selector.mid(pseudo);
+            }
+            result += QLatin1Char('{') + rule.body + QLatin1Char('}');
+        }
+        return result;
+    }
+
+    // Subjects of the selectors whose declarations differ between the two
+    // sets, or which only exist in one of them
+    QVector<ThemeSelector> changedSubjects(const ThemeRuleSet &other) const {
+        const QHash<QString, QString> mine = declarations();
+        const QHash<QString, QString> theirs = other.declarations();
+
+        QVector<ThemeSelector> subjects;
+        auto addSubject = [&subjects](const QString &selector) {
+            const ThemeSelector subject = subjectOf(selector);
+            if (!subjects.contains(subject)) {
+                subjects.append(subject);
+            }
+        };
+        for (auto it = mine.cbegin(); it != mine.cend(); ++it) {
+            if (theirs.value(it.key()) != it.value()) {
+                addSubject(it.key());
+            }
+        }
+        for (auto it = theirs.cbegin(); it != theirs.cend(); ++it) {
+            if (!mine.contains(it.key())) {
+                addSubject(it.key());
+            }
+        }
+        return subjects;
+    }
+
+private:
+    struct Rule {
+        QString selector;
+        QString body;
+    };
+
+    QHash<QString, QString> declarations() const {
+        QHash<QString, QString> result;
+        for (const Rule &rule : m_rules) {
+            result[rule.selector] += rule.body + QLatin1Char(';');
+        }
+        return result;
+    }
+
+    static ThemeSelector subjectOf(const QString &selector) {
+        const int combinator = qMax(selector.lastIndexOf(QLatin1Char('>')),
+                                    selector.lastIndexOf(QLatin1Char(' ')));
+        const QString compound = selector.mid(combinator + 1);
+
+        static const QRegularExpression delimiters(QStringLiteral("[#\\[:.]"));
+        const int typeEnd = compound.indexOf(delimiters);
+
+        ThemeSelector subject;
+        subject.className = compound.left(typeEnd).replace(QStringLiteral("--"), QStringLiteral("::")).toLatin1();
+
+        const int hash = compound.indexOf(QLatin1Char('#'));
+        if (hash >= 0) {
+            const int nameEnd = compound.indexOf(delimiters, hash + 1);
+            subject.objectName = compound.mid(hash + 1, nameEnd < 0 ? -1 : nameEnd - hash - 1);
+        }
+        return subject;
+    }
+
+    QVector<Rule> m_rules;
+};
+
+#endif // THEMEDIFF_H
@@ -0,0 +1,263 @@
+#ifndef THEMEENGINE_H
+#define THEMEENGINE_H
+
+#include <QWidget>
+#include <QPainter>
+#include <QPalette>
+#include <QProxyStyle>
+#include <QStyleOption>
+#include <QMenu>
+#include <QMenuBar>
+#include <QLabel>
+
+#include <widgetframe/windowbar.h>
+#include <widgetframe/windowbutton.h>
+
+#include "iconcache.hpp"
+#include "themetokens.h"
+
+enum Theme {
+    Dark,
+    Light,
+};
+
+// How FramelessHelper applies a theme.
+//  - StyleSheet:            load the qss from resources and set it on the target (default)
+//  - IncrementalStyleSheet: set both themes once, switching flips a property and
+//                           repolishes only the widgets whose rules differ
+//  - Native:                swap a precomputed palette, chrome is drawn by FramelessStyle
+enum class ThemeMode {
+    StyleSheet,
+    IncrementalStyleSheet,
+    Native,
+};
+
+// Colors the application paints itself: the title bar background in every
+// theme mode, and all chrome in Native mode. They come from the same .tokens
+// files as the style sheets, through the themetokens.h written by themes.pri.
+struct ThemePalette {
+    QColor barActive;
+    QColor barInactive;
+    QColor titleText;
+    QColor buttonHover;
+    QColor closeHover;
+    QColor menuBarText;
+    QColor menuBarHover;
+    QColor menuBackground;
+    QColor menuText;
+    QColor menuSelected;
+    QColor menuSelectedText;
+    QColor windowBackground;
+    QColor windowText;
+
+    static const ThemePalette &forTheme(Theme theme) {
+        static const ThemePalette dark = fromTokens(ThemeTokens_dark);
+        static const ThemePalette light = fromTokens(ThemeTokens_light);
+        return theme == Dark ? dark : light;
+    }
+
+    static ThemePalette fromTokens(const ThemeToken *tokens) {
+        return {
+            color(tokens, "bar-active"),        color(tokens, "bar-inactive"),
+            color(tokens, "title-text"),        color(tokens, "button-hover"),
+            color(tokens, "close-hover"),       color(tokens, "menubar-text"),
+            color(tokens, "menubar-hover"),     color(tokens, "menu-background"),
+            color(tokens, "menu-text"),         color(tokens, "menu-selected"),
+            color(tokens, "menu-selected-text"), color(tokens, "window-background"),
+            color(tokens, "content-text"),
+        };
+    }
+
+    // Token values as written for the qss: "#RRGGBB", color names and
+    // "rgba(r, g, b, a)" with the alpha in 0-255 or in percent. themes.pri
+    // guarantees that every palette token is defined.
+    static QColor color(const ThemeToken *tokens, const char *name) {
+        for (; tokens->name; ++tokens) {
+            if (qstrcmp(tokens->name, name) != 0)
+                continue;
+
+            const QString value = QString::fromLatin1(tokens->value);
+            if (!value.startsWith(QStringLiteral("rgba(")) || !value.endsWith(QLatin1Char(')')))
+                return QColor(value);
+
+            const QStringList parts = value.mid(5, value.size() - 6).split(QLatin1Char(','));
+            if (parts.size() != 4)
+                break;
+            const QString alpha = parts.at(3).trimmed();
+            return QColor(parts.at(0).trimmed().toInt(), parts.at(1).trimmed().toInt(),
+                          parts.at(2).trimmed().toInt(),
+                          alpha.endsWith(QLatin1Char('%'))
+                              ? qRound(alpha.left(alpha.size() - 1).toDouble() * 255 / 100)
+                              : alpha.toInt());
+        }
+        qWarning("ThemePalette: bad or missing token %s", name);
+        return {};
+    }
+
+    // Palette for the frameless window and everything it hosts
+    QPalette windowPalette(QPalette pal) const {
+        pal.setColor(QPalette::Window, windowBackground);
+        pal.setColor(QPalette::WindowText, windowText);
+        pal.setColor(QPalette::Text, windowText);
+        pal.setColor(QPalette::ButtonText, windowText);
+        return pal;
+    }
+
+    // Palette for the WindowBar subtree. The active/inactive background is
+    // stored in the matching color groups so that window activation only
+    // needs a repaint.
+    QPalette barPalette(QPalette pal) const {
+        pal.setColor(QPalette::Active, QPalette::Window, barActive);
+        pal.setColor(QPalette::Inactive, QPalette::Window, barInactive);
+        pal.setColor(QPalette::Disabled, QPalette::Window, barInactive);
+        pal.setColor(QPalette::WindowText, titleText);
+        pal.setColor(QPalette::ButtonText, menuBarText);
+        pal.setColor(QPalette::Midlight, buttonHover);
+        pal.setColor(QPalette::Dark, closeHover);
+        pal.setColor(QPalette::Light, menuBarHover);
+        return pal;
+    }
+
+    QPalette menuPalette(QPalette pal) const {
+        pal.setColor(QPalette::Window, menuBackground);
+        pal.setColor(QPalette::WindowText, menuText);
+        pal.setColor(QPalette::ButtonText, menuText);
+        pal.setColor(QPalette::Text, menuText);
+        pal.setColor(QPalette::Highlight, menuSelected);
+        pal.setColor(QPalette::HighlightedText, menuSelectedText);
+        return pal;
+    }
+};
+
+// Proxy style drawing the frameless chrome without a style sheet. The colors
+// come from the widget palette, so switching themes never re-polishes.
+class FramelessStyle : public QProxyStyle {
+public:
+    using QProxyStyle::polish;
+    using QProxyStyle::unpolish;
+
+    FramelessStyle() : QProxyStyle() {
+    }
+
+    static bool isSystemButton(const QWidget *w) {
+        return w && w->property("system-button").toBool();
+    }
+
+    static bool isWindowBarChild(const QWidget *w) {
+        return w && qobject_cast<const QWK::WindowBar *>(w->parentWidget());
+    }
+
+    void polish(QWidget *widget) override {
+        QProxyStyle::polish(widget);
+
+        if (qobject_cast<QWK::WindowBar *>(widget)) {
+            widget->setAutoFillBackground(true);
+            return;
+        }
+
+        if (qobject_cast<QMenu *>(widget)) {
+            widget->setAttribute(Qt::WA_WindowPropagation);
+            return;
+        }
+
+        if (!isWindowBarChild(widget)) {
+            return;
+        }
+
+        if (auto label = qobject_cast<QLabel *>(widget)) {
+            if (label->objectName() == QStringLiteral("win-title-label")) {
+                label->setMinimumHeight(28);
+            }
+            return;
+        }
+
+        auto button = qobject_cast<QWK::WindowButton *>(widget);
+        if (!button) {
+            return;
+        }
+        button->setFocusPolicy(Qt::NoFocus);
+        button->setAttribute(Qt::WA_Hover);
+
+        WindowBarIcons::apply(button);
+        if (button->objectName() == QStringLiteral("icon-button")) {
+            button->setIconSize(QSize(18, 18));
+            button->setMinimumWidth(40);
+            return;
+        }
+
+        button->setIconSize(button->objectName() == QStringLiteral("pin-button") ? QSize(15, 15)
+                                                                                  : QSize(12, 12));
+        button->setMinimumWidth(50);
+    }
+
+    void unpolish(QWidget *widget) override {
+        if (qobject_cast<QWK::WindowBar *>(widget)) {
+            widget->setAutoFillBackground(false);
+        }
+        QProxyStyle::unpolish(widget);
+    }
+
+    void drawControl(ControlElement element, const QStyleOption *option, QPainter *painter,
+                     const QWidget *widget = nullptr) const override {
+        switch (element) {
+            case CE_PushButtonBevel: {
+                if (!isWindowBarChild(widget)) {
+                    break;
+                }
+                // Transparent unless hovered or pressed, like the qss rules
+                if (option->state & (State_MouseOver | State_Sunken)) {
+                    if (!isSystemButton(widget)) {
+                        return;
+                    }
+                    const QColor color =
+                        widget->objectName() == QStringLiteral("close-button")
+                            ? option->palette.color(QPalette::Dark)
+                            : option->palette.color(QPalette::Midlight);
+                    painter->fillRect(option->rect, color);
+                }
+                return;
+            }
+
+            case CE_MenuBarEmptyArea: {
+                if (isWindowBarChild(widget)) {
+                    return;
+                }
+                break;
+            }
+
+            case CE_MenuBarItem: {
+                if (!isWindowBarChild(widget)) {
+                    break;
+                }
+                const auto item = qstyleoption_cast<const QStyleOptionMenuItem *>(option);
+                if (!item) {
+                    break;
+                }
+                if (item->state & (State_Selected | State_Sunken)) {
+                    painter->fillRect(item->rect, item->palette.color(QPalette::Light));
+                }
+                drawItemText(painter, item->rect,
+                             Qt::AlignCenter | Qt::TextShowMnemonic | Qt::TextDontClip |
+                                 Qt::TextSingleLine,
+                             item->palette, item->state & State_Enabled, item->text,
+                             QPalette::ButtonText);
+                return;
+            }
+
+            default:
+                break;
+        }
+        QProxyStyle::drawControl(element, option, painter, widget);
+    }
+
+    QSize sizeFromContents(ContentsType type, const QStyleOption *option, const QSize &size,
+                           const QWidget *widget = nullptr) const override {
+        if (type == CT_MenuBarItem && isWindowBarChild(widget)) {
+            // padding: 8px 12px
+            return size + QSize(24, 16);
+        }
+        return QProxyStyle::sizeFromContents(type, option, size, widget);
+    }
+};
+
+#endif // THEMEENGINE_H
@@ -0,0 +1,136 @@
+#ifndef THEMEREGISTRY_H
+#define THEMEREGISTRY_H
+
+#include <QObject>
+#include <QPointer>
+#include <QFile>
+#include <QCoreApplication>
+
+#include "themeengine.hpp"
+#include "themediff.hpp"
+#include "startuppreloader.hpp"
+
+// Process-wide theme state shared by every FramelessHelper.
+//
+// Each qss is read and decoded once; all windows and dialogs receive the same
+// implicitly shared QString. The native FramelessStyle is a single instance as
+// well. setTheme() notifies every helper through one themeChanged signal.
+//
+// For ThemeMode::IncrementalStyleSheet both themes are merged into one sheet
+// scoped by the "frameless-theme" property of the host, together with the
+// selectors whose rules differ between the themes.
+class ThemeRegistry : public QObject {
+    Q_OBJECT
+public:
+    static ThemeRegistry *instance() {
+        static QPointer<ThemeRegistry> registry;
+        if (!registry) {
+            registry = new ThemeRegistry(QCoreApplication::instance());
+        }
+        return registry;
+    }
+
+    QString styleSheet(Theme theme) {
+        QString &sheet = m_styleSheets[theme];
+        if (sheet.isEmpty()) {
+            for (const QString &path : styleSheetPaths(theme)) {
+                sheet = StartupPreloader::styleSheet(path);
+                if (!sheet.isNull())
+                    break;
+                if (QFile qss(path); qss.open(QIODevice::ReadOnly | QIODevice::Text)) {
+                    sheet = QString::fromUtf8(qss.readAll());
+                    break;
+                }
+            }
+        }
+        return sheet;
+    }
+
+    // Prefer the minified output of the theme compiler (themes/themes.pri)
+    // and fall back to the hand-written sheets
+    static QStringList styleSheetPaths(Theme theme) {
+        return {
+            theme == Dark ? QStringLiteral(":/themes/dark.qss")
+                          : QStringLiteral(":/themes/light.qss"),
+            theme == Dark ? QStringLiteral(":/qss/dark-style.qss")
+                          : QStringLiteral(":/qss/light-style.qss"),
+        };
+    }
+
+    static constexpr const char *themeProperty = "frameless-theme";
+
+    static QString themeName(Theme theme) {
+        return theme == Dark ? QStringLiteral("dark") : QStringLiteral("light");
+    }
+
+    // Empty if one of the themes could not be loaded
+    QString incrementalStyleSheet() {
+        if (m_incrementalSheet.isEmpty()) {
+            const ThemeRuleSet dark(styleSheet(Dark));
+            const ThemeRuleSet light(styleSheet(Light));
+            if (dark.isEmpty() || light.isEmpty())
+                return {};
+
+            auto scope = [](Theme theme) {
+                return QStringLiteral("[%1=\"%2\"]").arg(QLatin1String(themeProperty), themeName(theme));
+            };
+            m_incrementalSheet = dark.qualified(scope(Dark)) + light.qualified(scope(Light));
+            m_themeDependents = dark.changedSubjects(light);
+        }
+        return m_incrementalSheet;
+    }
+
+    // Widgets styled differently by the two themes, see incrementalStyleSheet()
+    QVector<ThemeSelector> themeDependents() {
+        incrementalStyleSheet();
+        return m_themeDependents;
+    }
+
+    FramelessStyle *nativeStyle() {
+        if (!m_nativeStyle) {
+            m_nativeStyle = new FramelessStyle();
+            m_nativeStyle->setParent(this);
+        }
+        return m_nativeStyle;
+    }
+
+    Theme theme() const
+    {
+        return m_theme;
+    }
+
+    // The theme saved by the first window restored in the process becomes the
+    // theme of the process. Windows restored later, or after a theme has been
+    // chosen, take the current theme instead of switching the others to
+    // theirs. Returns the theme to construct the window with.
+    Theme restoreTheme(Theme saved) {
+        if (!m_themeSet) {
+            setTheme(saved);
+        }
+        return m_theme;
+    }
+
+    void setTheme(Theme theme) {
+        m_themeSet = true;
+        if (m_theme == theme)
+            return;
+        m_theme = theme;
+        Q_EMIT themeChanged(m_theme);
+    }
+
+Q_SIGNALS:
+    void themeChanged(Theme theme);
+
+private:
+    explicit ThemeRegistry(QObject *parent) : QObject(parent) {
+    }
+
+    QString m_styleSheets[2];
+    QString m_incrementalSheet;
+    QVector<ThemeSelector> m_themeDependents;
+    FramelessStyle *m_nativeStyle{nullptr};
+    Theme m_theme{Dark};
+    bool m_themeSet{false};
+};
+
+#endif // THEMEREGISTRY_H
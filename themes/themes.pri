@@ -0,0 +1,129 @@
+# Build-time theme compiler
+#
+# theme.qss.in is the single source of the window styles. For every theme in
+# THEME_NAMES the @token@ placeholders are replaced by the values of
+# <theme>.tokens, comments and whitespace are stripped, rules for parts the
+# application never creates are dropped, and every selector is checked against
+# the real class and object names. A malformed template or an unknown selector
+# stops qmake with an error. The results are embedded under :/themes/.
+#
+# The tokens are also written to themetokens.h, from which ThemePalette takes
+# the colors the application paints itself (title bar background, native
+# theme engine). Every theme has to define THEME_PALETTE_TOKENS.
+
+THEME_NAMES = dark light
+
+THEME_CLASS_NAMES = \
+    QWK--WindowBar QLabel QAbstractButton QMenuBar QToolButton QMenu QWidget \
+    FramelessWindow FramelessDialog
+
+THEME_OBJECT_NAMES = \
+    win-title-label win-menu-bar icon-button min-button max-button close-button \
+    qt_menubar_ext_button clock-widget test
+
+# Object names styled by the template but never created by FramelessHelper
+THEME_DEAD_OBJECT_NAMES = pin-button
+
+# Tokens read by ThemePalette
+THEME_PALETTE_TOKENS = \
+    bar-active bar-inactive title-text button-hover close-hover menubar-text \
+    menubar-hover menu-background menu-text menu-selected menu-selected-text \
+    window-background content-text
+
+THEME_OUT_DIR = $$OUT_PWD/themes
+
+THEME_SOURCE = $$cat($$PWD/theme.qss.in, blob)
+
+# Comments and whitespace
+THEME_SOURCE = $$replace(THEME_SOURCE, "/\\*[^*]*\\*+([^/*][^*]*\\*+)*/", "")
+THEME_SOURCE = $$replace(THEME_SOURCE, "\\s+", " ")
+THEME_SOURCE = $$replace(THEME_SOURCE, " ?([{};:>,]) ?", "\\1")
+THEME_SOURCE = $$replace(THEME_SOURCE, ";\\}", "}")
+THEME_SOURCE = $$replace(THEME_SOURCE, "^ | $", "")
+
+# Dead rules
+for(name, THEME_DEAD_OBJECT_NAMES) {
+    THEME_SOURCE = $$replace(THEME_SOURCE, "[^{}]*$${LITERAL_HASH}$${name}[^{}]*\\{[^}]*\\}", "")
+}
+
+# Structure
+THEME_OPEN_BRACES = $$replace(THEME_SOURCE, "[^{]", "")
+THEME_CLOSE_BRACES = $$replace(THEME_SOURCE, "[^}]", "")
+THEME_OPEN_COUNT = $$str_size($$THEME_OPEN_BRACES)
+!equals(THEME_OPEN_COUNT, $$str_size($$THEME_CLOSE_BRACES)) {
+    error("theme.qss.in: unbalanced braces")
+}
+contains(THEME_SOURCE, ".*\\{[^}]*\\{.*") {
+    error("theme.qss.in: nested or unterminated rule")
+}
+
+# Selectors
+THEME_SELECTORS = $$replace(THEME_SOURCE, "\\{[^}]*\\}", " ")
+THEME_SELECTORS = $$replace(THEME_SELECTORS, "\\[[^]]*\\]", "")
+THEME_SELECTORS = $$replace(THEME_SELECTORS, "::?[a-z-]+", "")
+THEME_SELECTORS = $$replace(THEME_SELECTORS, "[>,]", " ")
+THEME_SELECTORS = $$split(THEME_SELECTORS, " ")
+for(selector, THEME_SELECTORS) {
+    isEmpty(selector): next()
+    THEME_CLASS = $$section(selector, $$LITERAL_HASH, 0, 0)
+    THEME_OBJECT = $$section(selector, $$LITERAL_HASH, 1, 1)
+    !contains(THEME_CLASS_NAMES, $$THEME_CLASS) {
+        error("theme.qss.in: unknown class in selector $$selector")
+    }
+    !isEmpty(THEME_OBJECT):!contains(THEME_OBJECT_NAMES, $$THEME_OBJECT) {
+        error("theme.qss.in: unknown object name in selector $$selector")
+    }
+}
+
+THEME_QRC = "<RCC>" "<qresource prefix='/themes'>"
+THEME_HEADER = \
+    "// Generated by themes/themes.pri from the .tokens files, do not edit" \
+    "$${LITERAL_HASH}ifndef THEMETOKENS_H" \
+    "$${LITERAL_HASH}define THEMETOKENS_H" \
+    "" \
+    "struct ThemeToken {" \
+    "    const char *name;" \
+    "    const char *value;" \
+    "};"
+
+for(theme, THEME_NAMES) {
+    THEME_OUTPUT = $$THEME_SOURCE
+    THEME_DEFINED =
+    THEME_HEADER += "" "static const ThemeToken ThemeTokens_$${theme}[] = {"
+    THEME_TOKENS = $$cat($$PWD/$${theme}.tokens, lines)
+    for(line, THEME_TOKENS) {
+        contains(line, "^\\s*(//.*)?$"): next()
+        THEME_TOKEN = $$section(line, =, 0, 0)
+        THEME_TOKEN = $$replace(THEME_TOKEN, "\\s", "")
+        THEME_VALUE = $$section(line, =, 1)
+        THEME_VALUE = $$replace(THEME_VALUE, "^\\s+|\\s+$", "")
+        THEME_OUTPUT = $$replace(THEME_OUTPUT, "@$${THEME_TOKEN}@", $$THEME_VALUE)
+        THEME_DEFINED += $$THEME_TOKEN
+        THEME_HEADER += "    {\"$$THEME_TOKEN\", \"$$THEME_VALUE\"},"
+    }
+    THEME_HEADER += "    {nullptr, nullptr}," "};"
+    contains(THEME_OUTPUT, ".*@[a-z-]+@.*") {
+        error("$${theme}.tokens: unresolved tokens in theme.qss.in")
+    }
+    for(token, THEME_PALETTE_TOKENS) {
+        !contains(THEME_DEFINED, $$token) {
+            error("$${theme}.tokens: missing palette token $$token")
+        }
+    }
+
+    write_file($$THEME_OUT_DIR/$${theme}.qss, THEME_OUTPUT)|error("cannot write $${theme}.qss")
+    THEME_QRC += "<file>$${theme}.qss</file>"
+    QMAKE_INTERNAL_INCLUDED_FILES += $$PWD/$${theme}.tokens
+}
+
+THEME_QRC += "</qresource>" "</RCC>"
+write_file($$THEME_OUT_DIR/themes.qrc, THEME_QRC)|error("cannot write themes.qrc")
+
+THEME_HEADER += "" "$${LITERAL_HASH}endif // THEMETOKENS_H"
+write_file($$THEME_OUT_DIR/themetokens.h, THEME_HEADER)|error("cannot write themetokens.h")
+INCLUDEPATH += $$THEME_OUT_DIR
+
+# Re-run qmake when the template changes
+QMAKE_INTERNAL_INCLUDED_FILES += $$PWD/theme.qss.in
+
+RESOURCES += $$THEME_OUT_DIR/themes.qrc
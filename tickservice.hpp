@@ -0,0 +1,153 @@
+#ifndef TICKSERVICE_H
+#define TICKSERVICE_H
+
+#include <functional>
+
+#include <QObject>
+#include <QPointer>
+#include <QTimer>
+#include <QTime>
+#include <QVector>
+#include <QWidget>
+#include <QWindow>
+#include <QCoreApplication>
+
+// One application-wide clock for widgets that refresh once per second.
+//
+// A single precise timer is aligned to the next second boundary, so all
+// subscribers wake up together once a second instead of polling on their own
+// timers. A subscriber is only called while its window is exposed; the timer
+// stops completely when no subscribed window is visible.
+class TickService : public QObject {
+    Q_OBJECT
+public:
+    using Callback = std::function<void(const QTime &)>;
+
+    static TickService *instance() {
+        static QPointer<TickService> service;
+        if (!service) {
+            service = new TickService(QCoreApplication::instance());
+        }
+        return service;
+    }
+
+    void subscribe(QWidget *widget, const Callback &callback) {
+        Q_ASSERT(widget);
+        unsubscribe(widget);
+
+        m_subscribers.append({widget, callback});
+        connect(widget, &QObject::destroyed, this, [this, widget]() {
+            unsubscribe(widget); //
+        });
+        widget->installEventFilter(this);
+        watchWindow(widget->window());
+        refresh();
+    }
+
+    void unsubscribe(QWidget *widget) {
+        for (int i = m_subscribers.size() - 1; i >= 0; --i) {
+            if (!m_subscribers.at(i).widget || m_subscribers.at(i).widget == widget) {
+                m_subscribers.removeAt(i);
+            }
+        }
+        if (m_subscribers.isEmpty()) {
+            m_timer.stop();
+        }
+    }
+
+protected:
+    bool eventFilter(QObject *obj, QEvent *event) override {
+        switch (event->type()) {
+            case QEvent::ParentChange:
+                if (obj->isWidgetType()) {
+                    watchWindow(static_cast<QWidget *>(obj)->window());
+                }
+                break;
+            case QEvent::Show:
+                if (obj->isWidgetType()) {
+                    watchWindow(static_cast<QWidget *>(obj)->window());
+                }
+                Q_FALLTHROUGH();
+            case QEvent::Hide:
+            case QEvent::WindowStateChange:
+            case QEvent::Expose:
+                QTimer::singleShot(0, this, &TickService::refresh);
+                break;
+            default:
+                break;
+        }
+        return QObject::eventFilter(obj, event);
+    }
+
+private:
+    struct Subscriber {
+        QPointer<QWidget> widget;
+        Callback callback;
+    };
+
+    explicit TickService(QObject *parent) : QObject(parent) {
+        m_timer.setSingleShot(true);
+        m_timer.setTimerType(Qt::PreciseTimer);
+        connect(&m_timer, &QTimer::timeout, this, &TickService::tick);
+    }
+
+    static bool isExposed(const QWidget *widget) {
+        const QWidget *window = widget->window();
+        if (!widget->isVisible() || window->isMinimized()) {
+            return false;
+        }
+        const QWindow *handle = window->windowHandle();
+        return handle && handle->isExposed();
+    }
+
+    void watchWindow(QWidget *window) {
+        window->installEventFilter(this);
+        if (auto handle = window->windowHandle()) {
+            handle->installEventFilter(this);
+        }
+    }
+
+    bool anyExposed() const {
+        for (const Subscriber &sub : m_subscribers) {
+            if (sub.widget && isExposed(sub.widget)) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    // Called when visibility may have changed: refresh stale subscribers right
+    // away, then continue or stop ticking.
+    void refresh() {
+        if (!anyExposed()) {
+            m_timer.stop();
+            return;
+        }
+        if (!m_timer.isActive()) {
+            tick();
+        }
+    }
+
+    void tick() {
+        const QTime now = QTime::currentTime();
+        bool exposed = false;
+        const QVector<Subscriber> subscribers = m_subscribers;
+        for (const Subscriber &sub : subscribers) {
+            if (sub.widget && isExposed(sub.widget)) {
+                exposed = true;
+                sub.callback(now);
+            }
+        }
+        if (!exposed) {
+            return;
+        }
+
+        // Wake up just after the next second boundary
+        m_timer.start(1000 - QTime::currentTime().msec() + 1);
+    }
+
+    QTimer m_timer;
+    QVector<Subscriber> m_subscribers;
+};
+
+#endif // TICKSERVICE_H
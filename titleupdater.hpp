@@ -0,0 +1,182 @@
+#ifndef TITLEUPDATER_H
+#define TITLEUPDATER_H
+
+#include <QObject>
+#include <QPointer>
+#include <QLabel>
+#include <QHash>
+#include <QTimer>
+#include <QStyle>
+#include <QPainter>
+#include <QPaintEvent>
+#include <QFontMetrics>
+
+// The title label of the window bar. Its size hint does not depend on the
+// text, it takes the free width of the bar and elides what does not fit, so
+// a new title never changes the layout of the bar.
+//
+// setTitle() only repaints the label. The elided texts are cached for the
+// current width and font, a progress title cycling through a few values is
+// elided once per value. QLabel::setText() still works but updates the
+// geometry of the label and relayouts the bar, so FramelessHelper turns the
+// window bar's title following off and mirrors the window title through
+// setTitle() instead.
+class TitleLabel : public QLabel {
+public:
+    struct Stats {
+        int elisions{0};
+        int cacheHits{0};
+    };
+
+    explicit TitleLabel(QWidget *parent = nullptr) : QLabel(parent) {
+    }
+
+    void setTitle(const QString &title) {
+        if (m_hasTitle && title == m_title)
+            return;
+        m_title = title;
+        m_hasTitle = true;
+        update(contentsRect());
+    }
+
+    // Back to the text of the label
+    void clearTitle() {
+        m_title.clear();
+        m_hasTitle = false;
+        update();
+    }
+
+    QSize sizeHint() const override {
+        const QMargins margins = contentsMargins();
+        return {0, fontMetrics().height() + margins.top() + margins.bottom() + 2 * margin()};
+    }
+
+    QSize minimumSizeHint() const override {
+        return sizeHint();
+    }
+
+    Stats stats() const {
+        return m_stats;
+    }
+
+protected:
+    void paintEvent(QPaintEvent *event) override {
+        Q_UNUSED(event);
+        QPainter painter(this);
+        drawFrame(&painter);
+
+        const QRect rect = contentsRect().adjusted(margin(), margin(), -margin(), -margin());
+        style()->drawItemText(&painter, rect, QStyle::visualAlignment(layoutDirection(), alignment()),
+                              palette(), isEnabled(), elided(m_hasTitle ? m_title : text(), rect.width()),
+                              foregroundRole());
+    }
+
+private:
+    QString elided(const QString &source, int width) {
+        if (width != m_elideWidth || font() != m_elideFont) {
+            m_elided.clear();
+            m_elideWidth = width;
+            m_elideFont = font();
+        }
+        const auto it = m_elided.constFind(source);
+        if (it != m_elided.cend()) {
+            ++m_stats.cacheHits;
+            return it.value();
+        }
+
+        if (m_elided.size() == MaxCached) {
+            m_elided.clear();
+        }
+        ++m_stats.elisions;
+        const QString result = fontMetrics().elidedText(source, Qt::ElideRight, width);
+        m_elided.insert(source, result);
+        return result;
+    }
+
+    static constexpr const int MaxCached = 64;
+
+    QString m_title;
+    bool m_hasTitle{false};
+    QHash<QString, QString> m_elided;
+    int m_elideWidth{-1};
+    QFont m_elideFont;
+    Stats m_stats;
+};
+
+// Rate limited window title updates. The first title after a quiet period is
+// set right away, later ones at most once per interval, and only the latest
+// of the titles set in between. An interval of 0 sets every title. The title
+// label follows the window title (see TitleLabel).
+class TitleUpdater : public QObject {
+public:
+    struct Stats {
+        int requests{0};
+        int applied{0};
+        // Titles replaced by a newer one before they were shown
+        int dropped{0};
+    };
+
+    explicit TitleUpdater(QWidget *host) : QObject(host), m_host(host) {
+        m_timer.setSingleShot(true);
+        connect(&m_timer, &QTimer::timeout, this, [this]() {
+            if (m_dirty) {
+                apply();
+            }
+        });
+    }
+
+    int interval() const {
+        return m_timer.interval();
+    }
+
+    void setInterval(int ms) {
+        m_timer.setInterval(ms);
+        if (ms > 0)
+            return;
+
+        m_timer.stop();
+        if (m_dirty) {
+            apply();
+        }
+    }
+
+    void setTitle(const QString &title) {
+        ++m_stats.requests;
+        if (m_timer.interval() <= 0) {
+            m_host->setWindowTitle(title);
+            ++m_stats.applied;
+            return;
+        }
+
+        if (m_dirty) {
+            ++m_stats.dropped;
+        }
+        m_pending = title;
+        m_dirty = true;
+        if (!m_timer.isActive()) {
+            apply();
+        }
+    }
+
+    Stats stats() const {
+        return m_stats;
+    }
+
+private:
+    void apply() {
+        m_dirty = false;
+        ++m_stats.applied;
+        m_host->setWindowTitle(m_pending);
+        if (m_timer.interval() > 0) {
+            m_timer.start();
+        }
+    }
+
+    QPointer<QWidget> m_host;
+    QTimer m_timer;
+    QString m_pending;
+    bool m_dirty{false};
+    Stats m_stats;
+};
+
+#endif // TITLEUPDATER_H
@@ -0,0 +1,172 @@
+#ifndef TRACER_H
+#define TRACER_H
+
+#include <cstdio>
+#include <utility>
+
+#include <QFile>
+#include <QEvent>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QThread>
+#include <QVector>
+#include <QElapsedTimer>
+#include <QJsonArray>
+#include <QJsonObject>
+#include <QJsonDocument>
+
+// Timeline of the frameless window stack in the trace event format, which
+// chrome://tracing and Perfetto load directly. Enabled by the QWK_TRACE
+// environment variable, the value is the output file ("-" for stdout):
+//
+//     QWK_TRACE=trace.json ./QWKExample_MainWindow
+//
+// Every traced scope becomes one complete ("X") event on the thread it ran
+// on. The file is written by finish() when the application returns from
+// exec(). When disabled a scope costs a single branch.
+class Tracer {
+public:
+    static void start() {
+        State &s = state();
+        s.enabled = !qEnvironmentVariableIsEmpty("QWK_TRACE");
+        if (s.enabled) {
+            s.timer.start();
+        }
+    }
+
+    static bool isEnabled() {
+        return state().enabled;
+    }
+
+    static qint64 now() {
+        return state().timer.nsecsElapsed();
+    }
+
+    // name and category must be string literals
+    static void complete(const char *name, const char *category, qint64 start, qint64 end) {
+        State &s = state();
+        if (!s.enabled)
+            return;
+        const quintptr thread = reinterpret_cast<quintptr>(QThread::currentThreadId());
+        QMutexLocker locker(&s.mutex);
+        s.events.append({name, category, start, end, thread});
+    }
+
+    // Start of the layout of a frameless host, noted by its FramelessHelper
+    // event filter before the layout runs
+    static void markLayoutStart() {
+        State &s = state();
+        if (s.enabled) {
+            s.layoutStart = s.timer.nsecsElapsed();
+        }
+    }
+
+    static qint64 takeLayoutStart() {
+        return std::exchange(state().layoutStart, -1);
+    }
+
+    static void finish() {
+        State &s = state();
+        if (!s.enabled)
+            return;
+        s.enabled = false;
+
+        QJsonArray events;
+        for (const Event &event : std::as_const(s.events)) {
+            events.append(QJsonObject{
+                {QStringLiteral("name"), QString::fromLatin1(event.name)},
+                {QStringLiteral("cat"), QString::fromLatin1(event.category)},
+                {QStringLiteral("ph"), QStringLiteral("X")},
+                {QStringLiteral("ts"), event.start / 1e3},
+                {QStringLiteral("dur"), (event.end - event.start) / 1e3},
+                {QStringLiteral("pid"), 1},
+                {QStringLiteral("tid"), QString::number(event.thread)},
+            });
+        }
+        const QJsonObject result{
+            {QStringLiteral("traceEvents"), events},
+            {QStringLiteral("displayTimeUnit"), QStringLiteral("ms")},
+        };
+        const QByteArray json = QJsonDocument(result).toJson(QJsonDocument::Compact);
+
+        const QString target = qEnvironmentVariable("QWK_TRACE");
+        QFile out(target);
+        if (target == QStringLiteral("-") ? out.open(stdout, QIODevice::WriteOnly)
+                                          : out.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+            out.write(json);
+        } else {
+            qWarning("Tracer: cannot write %s", qPrintable(target));
+        }
+    }
+
+private:
+    struct Event {
+        const char *name;
+        const char *category;
+        qint64 start;
+        qint64 end;
+        quintptr thread;
+    };
+
+    struct State {
+        bool enabled{false};
+        QElapsedTimer timer;
+        QMutex mutex;
+        QVector<Event> events;
+        // GUI thread
+        qint64 layoutStart{-1};
+    };
+
+    static State &state() {
+        static State s;
+        return s;
+    }
+};
+
+// Traces the enclosing scope. A null name traces nothing, so a scope can be
+// picked at runtime; start overrides the begin of a scope that started
+// before it was constructed.
+class TraceScope {
+public:
+    TraceScope(const char *name, const char *category)
+        : m_name(name), m_category(category),
+          m_start(name && Tracer::isEnabled() ? Tracer::now() : -1) {
+    }
+
+    TraceScope(const char *name, const char *category, qint64 start)
+        : m_name(name), m_category(category), m_start(name && Tracer::isEnabled() ? start : -1) {
+    }
+
+    ~TraceScope() {
+        if (m_start >= 0) {
+            Tracer::complete(m_name, m_category, m_start, Tracer::now());
+        }
+    }
+
+    // To be kept alive while a frameless host's event() runs: "paint" for
+    // the backing store flush of the window, "layout" for its layout and
+    // "activation" for the polish of the active state
+    static TraceScope forHostEvent(const QEvent *event) {
+        switch (event->type()) {
+            case QEvent::UpdateRequest:
+                return TraceScope("paint", "frame");
+            case QEvent::LayoutRequest:
+                return TraceScope("layout", "frame", Tracer::takeLayoutStart());
+            case QEvent::WindowActivate:
+            case QEvent::WindowDeactivate:
+                return TraceScope("activation", "frame");
+            default:
+                return TraceScope(nullptr, nullptr);
+        }
+    }
+
+    TraceScope(const TraceScope &) = delete;
+    TraceScope &operator=(const TraceScope &) = delete;
+
+private:
+    const char *m_name;
+    const char *m_category;
+    qint64 m_start;
+};
+
+#endif // TRACER_H
@@ -0,0 +1,242 @@
+#ifndef UPDATECHANNEL_H
+#define UPDATECHANNEL_H
+
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <memory>
+
+#include <QObject>
+#include <QHash>
+#include <QMutex>
+#include <QTimer>
+#include <QVariant>
+#include <QElapsedTimer>
+
+// Status updates from worker threads to the GUI thread of a window.
+//
+// post() is callable from any number of threads and does not block while
+// there is room: the update goes into a bounded ring (a Vyukov-style queue, every slot carries a
+// sequence number the producers claim with one compare-and-swap). The GUI
+// thread drains the ring at most once per frame interval, keeps only the
+// latest value per key and then calls the binding of each key once. A burst
+// of updates costs a single posted event, the one that wakes the GUI thread
+// for the next drain.
+//
+// If the ring is full the update replaces the pending value of its key in a
+// small overflow table behind a mutex, so the latest value of every key is
+// always delivered, a final title or status included. The capacity should
+// cover the updates of one frame, the overflow is the slow path. Producers
+// must stop posting before the channel is destroyed.
+class UpdateChannel : public QObject {
+public:
+    using Binding = std::function<void(const QVariant &)>;
+
+    struct Stats {
+        qint64 posted{0};
+        // Updates that found the ring full and went to the overflow table
+        qint64 overflowed{0};
+        // Updates replaced by a newer value of their key in the same drain
+        qint64 coalesced{0};
+        qint64 delivered{0};
+        int drains{0};
+        // Most updates found in the ring by one drain
+        int maxDepth{0};
+        // Longest time from a post to its delivery
+        qint64 maxLatencyNs{0};
+    };
+
+    // capacity is rounded up to a power of two
+    explicit UpdateChannel(QObject *parent = nullptr, int capacity = 1024)
+        : QObject(parent), m_mask(roundUp(capacity) - 1), m_cells(new Cell[m_mask + 1]) {
+        for (quint64 i = 0; i <= m_mask; ++i) {
+            m_cells[i].sequence.store(i, std::memory_order_relaxed);
+        }
+        m_timer.setSingleShot(true);
+        m_timer.setTimerType(Qt::PreciseTimer);
+        connect(&m_timer, &QTimer::timeout, this, [this]() { drain(); });
+        m_sinceDrain.start();
+    }
+
+    // GUI thread
+    void bind(const QString &key, Binding binding) {
+        m_bindings.insert(key, std::move(binding));
+    }
+
+    // Shortest time between two drains, 16 ms by default
+    void setFrameInterval(int ms) {
+        m_frameInterval = ms;
+    }
+
+    // Any thread
+    void post(const QString &key, const QVariant &value) {
+        // Grows with every post of a thread. A key can be in the ring and in
+        // the overflow table, the drain keeps the value with the larger stamp.
+        const quint64 stamp = quint64(m_posted.fetch_add(1, std::memory_order_relaxed));
+
+        quint64 pos = m_enqueuePos.load(std::memory_order_relaxed);
+        Cell *cell;
+        for (;;) {
+            cell = &m_cells[pos & m_mask];
+            const quint64 sequence = cell->sequence.load(std::memory_order_acquire);
+            const qint64 diff = qint64(sequence) - qint64(pos);
+            if (diff == 0) {
+                if (m_enqueuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                    break;
+            } else if (diff < 0) {
+                overflow(key, value, stamp);
+                wakeUp();
+                return;
+            } else {
+                pos = m_enqueuePos.load(std::memory_order_relaxed);
+            }
+        }
+        cell->key = key;
+        cell->value = value;
+        cell->stamp = stamp;
+        cell->postedNs = now();
+        cell->sequence.store(pos + 1, std::memory_order_release);
+        wakeUp();
+    }
+
+    // GUI thread
+    Stats stats() const {
+        Stats stats = m_stats;
+        stats.posted = m_posted.load(std::memory_order_relaxed);
+        stats.overflowed = m_overflowed.load(std::memory_order_relaxed);
+        return stats;
+    }
+
+    // Delivers what is in the ring and the overflow table now, without
+    // waiting for the frame
+    void drain() {
+        m_timer.stop();
+        // Posts from here on schedule the next drain. Reading the flag pairs
+        // with the producer that set it, its update is visible below.
+        m_scheduled.exchange(false, std::memory_order_acq_rel);
+        m_sinceDrain.restart();
+
+        QHash<QString, Pending> latest;
+        int depth = 0;
+        for (;;) {
+            Cell &cell = m_cells[m_dequeuePos & m_mask];
+            if (cell.sequence.load(std::memory_order_acquire) != m_dequeuePos + 1)
+                break;
+
+            merge(latest[cell.key], {std::move(cell.value), cell.stamp, cell.postedNs, 1});
+            cell.value = QVariant();
+            cell.sequence.store(m_dequeuePos + m_mask + 1, std::memory_order_release);
+            ++m_dequeuePos;
+            ++depth;
+        }
+
+        // Posted before the ring had room again, or before a newer value of
+        // their key in the ring; the stamps tell which value is the latest
+        QHash<QString, Pending> overflow;
+        {
+            QMutexLocker locker(&m_overflowMutex);
+            overflow.swap(m_overflow);
+        }
+        for (auto it = overflow.begin(); it != overflow.end(); ++it) {
+            merge(latest[it.key()], std::move(it.value()));
+        }
+        if (latest.isEmpty())
+            return;
+
+        ++m_stats.drains;
+        m_stats.maxDepth = qMax(m_stats.maxDepth, depth);
+        const qint64 drainedNs = now();
+        for (auto it = latest.cbegin(); it != latest.cend(); ++it) {
+            m_stats.maxLatencyNs = qMax(m_stats.maxLatencyNs, drainedNs - it->postedNs);
+            m_stats.coalesced += it->posts - 1;
+            ++m_stats.delivered;
+            if (const Binding binding = m_bindings.value(it.key())) {
+                binding(it->value);
+            }
+        }
+    }
+
+private:
+    struct Cell {
+        std::atomic<quint64> sequence{0};
+        QString key;
+        QVariant value;
+        quint64 stamp{0};
+        qint64 postedNs{0};
+    };
+
+    // The value to deliver for a key and how many posts it stands for
+    struct Pending {
+        QVariant value;
+        quint64 stamp{0};
+        // The oldest of the posts
+        qint64 postedNs{0};
+        int posts{0};
+    };
+
+    static void merge(Pending &into, Pending &&update) {
+        if (into.posts == 0 || update.stamp > into.stamp) {
+            into.value = std::move(update.value);
+            into.stamp = update.stamp;
+        }
+        into.postedNs = into.posts == 0 ? update.postedNs : qMin(into.postedNs, update.postedNs);
+        into.posts += update.posts;
+    }
+
+    // Any thread, the ring is full
+    void overflow(const QString &key, const QVariant &value, quint64 stamp) {
+        m_overflowed.fetch_add(1, std::memory_order_relaxed);
+        const qint64 postedNs = now();
+        QMutexLocker locker(&m_overflowMutex);
+        merge(m_overflow[key], {value, stamp, postedNs, 1});
+    }
+
+    // Any thread, after the update is in the ring or the overflow table
+    void wakeUp() {
+        if (!m_scheduled.exchange(true, std::memory_order_acq_rel)) {
+            QMetaObject::invokeMethod(this, [this]() { scheduleDrain(); }, Qt::QueuedConnection);
+        }
+    }
+
+    static quint64 roundUp(int capacity) {
+        quint64 size = 2;
+        while (size < quint64(qMax(capacity, 2))) {
+            size <<= 1;
+        }
+        return size;
+    }
+
+    static qint64 now() {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(
+                   std::chrono::steady_clock::now().time_since_epoch())
+            .count();
+    }
+
+    // GUI thread, once per wake-up
+    void scheduleDrain() {
+        const qint64 remaining = m_frameInterval - m_sinceDrain.elapsed();
+        if (remaining <= 0) {
+            drain();
+        } else if (!m_timer.isActive()) {
+            m_timer.start(int(remaining));
+        }
+    }
+
+    const quint64 m_mask;
+    std::unique_ptr<Cell[]> m_cells;
+    alignas(64) std::atomic<quint64> m_enqueuePos{0};
+    alignas(64) quint64 m_dequeuePos{0};
+    std::atomic<bool> m_scheduled{false};
+    std::atomic<qint64> m_posted{0};
+    std::atomic<qint64> m_overflowed{0};
+    QMutex m_overflowMutex;
+    QHash<QString, Pending> m_overflow;
+
+    QHash<QString, Binding> m_bindings;
+    QTimer m_timer;
+    QElapsedTimer m_sinceDrain;
+    int m_frameInterval{16};
+    Stats m_stats;
+};
+
+#endif // UPDATECHANNEL_H
@@ -0,0 +1,32 @@
+#ifndef WINDOWATTRIBUTESINK_H
+#define WINDOWATTRIBUTESINK_H
+
+#include <QString>
+#include <QVariant>
+
+#include <QWKWidgets/widgetwindowagent.h>
+
+// Where FramelessHelper sends window attributes (mica, blur-effect...). The
+// window agent in the application, a recording double in the tests.
+class WindowAttributeSink {
+public:
+    virtual ~WindowAttributeSink() = default;
+
+    // Returns false if the platform rejected the attribute
+    virtual bool setWindowAttribute(const QString &key, const QVariant &value) = 0;
+};
+
+class AgentAttributeSink : public WindowAttributeSink {
+public:
+    explicit AgentAttributeSink(QWK::WidgetWindowAgent *agent) : m_agent(agent) {
+    }
+
+    bool setWindowAttribute(const QString &key, const QVariant &value) override {
+        return m_agent->setWindowAttribute(key, value);
+    }
+
+private:
+    QWK::WidgetWindowAgent *m_agent;
+};
+
+#endif // WINDOWATTRIBUTESINK_H
@@ -0,0 +1,129 @@
+#ifndef WINDOWSTATE_H
+#define WINDOWSTATE_H
+
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QRect>
+#include <QScreen>
+#include <QWidget>
+#include <QSaveFile>
+#include <QDataStream>
+#include <QStandardPaths>
+#include <QGuiApplication>
+
+#include "themeengine.hpp"
+
+// Persistent state of a frameless window, stored per window id in a small
+// binary file under the application config location.
+//
+// The state is meant to be read before the window and its FramelessHelper
+// are constructed: the theme and theme mode go into the helper constructor,
+// apply() sets the geometry, the window state and the custom style property
+// while the window is still hidden. The first show() then runs one polish and
+// one layout pass with the final values, instead of correcting a default
+// 800x600 dark window afterwards.
+struct WindowState {
+    QRect geometry;
+    bool maximized{false};
+    Theme theme{Dark};
+    ThemeMode themeMode{ThemeMode::StyleSheet};
+    // Window attribute of the custom window style ("mica", "dwm-blur"...), empty for none
+    QString windowStyle;
+
+    static WindowState load(const QString &id) {
+        WindowState state;
+        QFile file(path(id));
+        if (!file.open(QIODevice::ReadOnly))
+            return state;
+
+        QDataStream in(&file);
+        in.setVersion(QDataStream::Qt_5_15);
+        quint32 magic = 0;
+        quint8 version = 0;
+        in >> magic >> version;
+        if (magic != Magic || version != Version)
+            return state;
+
+        qint32 x, y, width, height;
+        quint8 flags, theme, themeMode;
+        QString windowStyle;
+        in >> x >> y >> width >> height >> flags >> theme >> themeMode >> windowStyle;
+        if (in.status() != QDataStream::Ok || theme > Light || themeMode > quint8(ThemeMode::Native))
+            return state;
+
+        state.geometry = QRect(x, y, width, height);
+        state.maximized = flags & Maximized;
+        state.theme = Theme(theme);
+        state.themeMode = ThemeMode(themeMode);
+        state.windowStyle = windowStyle;
+        return state;
+    }
+
+    bool save(const QString &id) const {
+        const QString filePath = path(id);
+        QDir().mkpath(QFileInfo(filePath).absolutePath());
+
+        QSaveFile file(filePath);
+        if (!file.open(QIODevice::WriteOnly))
+            return false;
+
+        QDataStream out(&file);
+        out.setVersion(QDataStream::Qt_5_15);
+        out << Magic << Version << qint32(geometry.x()) << qint32(geometry.y())
+            << qint32(geometry.width()) << qint32(geometry.height())
+            << quint8(maximized ? Maximized : 0) << quint8(theme) << quint8(themeMode) << windowStyle;
+        return out.status() == QDataStream::Ok && file.commit();
+    }
+
+    // The normal geometry is kept while the window is maximized, so restoring
+    // it returns to the size the user chose
+    static WindowState capture(const QWidget *window, Theme theme, ThemeMode themeMode,
+                               const QString &windowStyle) {
+        WindowState state;
+        state.geometry = window->normalGeometry();
+        state.maximized = window->isMaximized();
+        state.theme = theme;
+        state.themeMode = themeMode;
+        state.windowStyle = windowStyle;
+        return state;
+    }
+
+    // To be called before the first show(). Returns false if there was no
+    // usable geometry and the caller has to pick a default size.
+    bool apply(QWidget *window) const {
+        window->setProperty("custom-style", !windowStyle.isEmpty());
+        if (!isOnScreen())
+            return false;
+
+        window->setGeometry(geometry);
+        if (maximized) {
+            window->setWindowState(window->windowState() | Qt::WindowMaximized);
+        }
+        return true;
+    }
+
+private:
+    static constexpr const quint32 Magic = 0x51574B53; // "QWKS"
+    static constexpr const quint8 Version = 1;
+    static constexpr const quint8 Maximized = 0x01;
+
+    static QString path(const QString &id) {
+        return QStandardPaths::writableLocation(QStandardPaths::AppConfigLocation) +
+               QStringLiteral("/window-state/") + id + QStringLiteral(".bin");
+    }
+
+    // Monitors may have been rearranged since the state was saved
+    bool isOnScreen() const {
+        if (!geometry.isValid())
+            return false;
+        const auto screens = QGuiApplication::screens();
+        for (const QScreen *screen : screens) {
+            if (screen->availableGeometry().intersects(geometry))
+                return true;
+        }
+        return false;
+    }
+};
+
+#endif // WINDOWSTATE_H